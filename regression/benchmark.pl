@@ -0,0 +1,307 @@
+#!/usr/bin/perl
+
+use strict;
+use warnings;
+use File::Basename;
+use Getopt::Long qw(:config bundling);
+use JSON::PP;
+use Time::HiRes qw(time);
+
+use Cwd;
+
+# benchmark.pl
+#
+# runs the regression suites under each engine configuration, records
+# median run time, CEGIS iterations and peak memory, and compares the
+# numbers against a stored baseline
+
+my @default_configs = (
+  "",
+  "--incremental",
+  "--simplifying-solver",
+  "--fm",
+  "--local-search",
+  "--smt");
+
+sub usage {
+  print <<EOF;
+benchmark.pl [OPTIONS] [SUITE]...
+
+  runs all CORE tests in the given suite directories (default: the
+  fastsynth-sygus and fastsynth-C suites) under every engine
+  configuration, repeating each run, and stores the results as JSON
+
+  -c CMD              the fastsynth binary to benchmark (required)
+  -r N                repetitions per test and configuration (default 5)
+  -e OPTIONS          engine configuration to run, may be repeated
+                      (default: plain, --incremental, --simplifying-solver,
+                      --fm, --local-search, --smt)
+  -t SECONDS          time limit per run (default 300)
+  -o FILE             write results to FILE (default benchmark.json)
+  -b FILE             compare against the baseline in FILE
+  --alpha P           significance level for slowdowns (default 0.05)
+  --threshold F       minimum relative slowdown of the median to report
+                      (default 0.1)
+  -h                  show this help
+
+Runs whose output does not contain a result are recorded as failed.
+Peak memory is read from /usr/bin/time, when available, and otherwise from
+the statistics of fastsynth, which also attribute its growth to phases.
+EOF
+  exit 1;
+}
+
+sub median {
+  my @sorted = sort { $a <=> $b } @_;
+  my $n = scalar @sorted;
+  return undef if $n == 0;
+  return $sorted[$n/2] if $n % 2;
+  return ($sorted[$n/2-1] + $sorted[$n/2]) / 2;
+}
+
+# Probability that the Mann-Whitney statistic of two samples of sizes $m
+# and $n is at least $u, assuming both come from the same distribution.
+# Exact for small samples, normal approximation otherwise.
+sub mann_whitney_p($$$) {
+  my ($u, $m, $n) = @_;
+
+  if($m * $n <= 400) {
+    # f[i][j][k]: number of orderings of i+j values giving statistic k
+    my @f;
+    for my $i (0..$m) {
+      for my $j (0..$n) {
+        for my $k (0..$m*$n) {
+          if($i == 0 || $j == 0) {
+            $f[$i][$j][$k] = $k == 0 ? 1 : 0;
+          } else {
+            $f[$i][$j][$k] = ($k >= $j ? $f[$i-1][$j][$k-$j] : 0)
+                           + $f[$i][$j-1][$k];
+          }
+        }
+      }
+    }
+
+    my ($total, $tail) = (0, 0);
+    for my $k (0..$m*$n) {
+      $total += $f[$m][$n][$k];
+      $tail += $f[$m][$n][$k] if $k >= $u - 1e-9;
+    }
+    return $tail / $total;
+  }
+
+  my $mean = $m * $n / 2;
+  my $sd = sqrt($m * $n * ($m + $n + 1) / 12);
+  my $z = ($u - 0.5 - $mean) / $sd;
+  # upper tail of the standard normal distribution
+  my $t = 1 / (1 + 0.2316419 * abs($z));
+  my $poly = $t * (0.319381530 + $t * (-0.356563782 + $t * (1.781477937
+           + $t * (-1.821255978 + $t * 1.330274429))));
+  my $tail = exp(-$z * $z / 2) / sqrt(2 * 3.14159265358979) * $poly;
+  return $z >= 0 ? $tail : 1 - $tail;
+}
+
+# One-sided test whether the times in $new are larger than in $old.
+sub slowdown_p($$) {
+  my ($old, $new) = @_;
+  my @all = map { [$_, 0] } @$old;
+  push @all, map { [$_, 1] } @$new;
+  @all = sort { $a->[0] <=> $b->[0] } @all;
+
+  # mid-ranks for ties
+  my $rank_sum = 0;
+  my $i = 0;
+  while($i < @all) {
+    my $j = $i;
+    $j++ while($j + 1 < @all && $all[$j + 1][0] == $all[$i][0]);
+    my $rank = ($i + $j) / 2 + 1;
+    for my $k ($i..$j) {
+      $rank_sum += $rank if $all[$k][1];
+    }
+    $i = $j + 1;
+  }
+
+  my $n = scalar @$new;
+  my $m = scalar @$old;
+  my $u = $rank_sum - $n * ($n + 1) / 2;
+  return mann_whitney_p($u, $n, $m);
+}
+
+sub load_desc($) {
+  my ($fname) = @_;
+  open my $FH, "<$fname" or return ();
+  my @data = grep { !/^\/\// } <$FH>;
+  close $FH;
+  chomp @data;
+  return @data;
+}
+
+sub run_once($$$$$) {
+  my ($dir, $cmd, $options, $input, $time_limit) = @_;
+  my $output = "benchmark.out";
+
+  my $prefix = "";
+  $prefix = "timeout -s KILL $time_limit " if(system("which timeout >/dev/null 2>&1") == 0);
+
+  my $rss_file = "benchmark-rss.out";
+  my $time_cmd = "";
+  $time_cmd = "/usr/bin/time -o '$rss_file' -f '%M' " if(-x "/usr/bin/time");
+
+  my $start = time();
+  system("bash", "-c", "cd '$dir' ; $prefix$time_cmd$cmd $options '$input' >'$output' 2>&1");
+  my $elapsed = time() - $start;
+  my $exit_value = $? >> 8;
+  my $signal_num = $? & 127;
+
+  my %result = (time => $elapsed, exit => $exit_value, signal => $signal_num);
+
+  if(open my $FH, "<$dir/$output") {
+    my $iterations;
+    while(my $line = <$FH>) {
+      $result{solved} = 1 if($line =~ /^VERIFICATION SUCCESSFUL|^Result: /);
+      $iterations = $1 if($line =~ /Result obtained with (\d+) iteration/);
+      $iterations = $1 if(!defined($iterations) && $line =~ /CEGIS local search successful (\d+)/);
+      $result{last_iteration} = $1 if($line =~ /CEGIS iteration (\d+)/);
+      $result{peak_memory_kb} = $1 if($line =~ /^Peak memory: (\d+) KB/);
+      $result{memory_growth_kb}{$1} = $2 if($line =~ /^Peak memory growth in (.+): (\d+) KB/);
+    }
+    close $FH;
+    $result{iterations} = defined($iterations) ? $iterations : $result{last_iteration};
+  }
+
+  if($time_cmd ne "" && open my $FH, "<$dir/$rss_file") {
+    while(my $line = <$FH>) {
+      $result{peak_rss_kb} = $1 if($line =~ /^(\d+)$/);
+    }
+    close $FH;
+    unlink "$dir/$rss_file";
+  }
+
+  return \%result;
+}
+
+my $cmd;
+my $repetitions = 5;
+my @configs;
+my $time_limit = 300;
+my $output_file = "benchmark.json";
+my $baseline_file;
+my $alpha = 0.05;
+my $threshold = 0.1;
+my $help;
+
+GetOptions(
+  "c=s" => \$cmd,
+  "r=i" => \$repetitions,
+  "e=s" => \@configs,
+  "t=i" => \$time_limit,
+  "o=s" => \$output_file,
+  "b=s" => \$baseline_file,
+  "alpha=f" => \$alpha,
+  "threshold=f" => \$threshold,
+  "h" => \$help) or usage();
+
+usage() if($help || !defined($cmd));
+
+# make the command absolute, as the tests run in their own directories
+$cmd = Cwd::abs_path($cmd) if(-e $cmd);
+
+@configs = @default_configs if(!@configs);
+my @suites = @ARGV;
+my $script_dir = dirname(Cwd::abs_path($0));
+@suites = ("$script_dir/fastsynth-sygus", "$script_dir/fastsynth-C") if(!@suites);
+
+my %results;
+
+foreach my $suite (@suites) {
+  opendir(my $DH, $suite) or die "Cannot open suite '$suite': $!";
+  my @tests = sort grep { -f "$suite/$_/test.desc" } readdir($DH);
+  closedir($DH);
+
+  foreach my $test (@tests) {
+    my $dir = "$suite/$test";
+    my ($level, $input, $options) = load_desc("$dir/test.desc");
+    next if(!defined($level) || $level !~ /^CORE/);
+    $options = "" if(!defined($options));
+
+    my $name = basename(Cwd::abs_path($suite)) . "/$test";
+
+    foreach my $config (@configs) {
+      my $config_name = $config eq "" ? "default" : $config;
+      print "$name [$config_name]";
+
+      my (@times, @iterations, @rss, %growth);
+      my $solved = 1;
+
+      for(my $i = 0; $i < $repetitions; $i++) {
+        my $run = run_once($dir, $cmd, "$options $config", $input, $time_limit);
+        push @times, $run->{time};
+        push @iterations, $run->{iterations} if(defined($run->{iterations}));
+        push @rss, $run->{peak_rss_kb} if(defined($run->{peak_rss_kb}));
+        # fall back to the statistics printed by fastsynth
+        push @rss, $run->{peak_memory_kb} if(!defined($run->{peak_rss_kb}) && defined($run->{peak_memory_kb}));
+        foreach my $phase (keys %{$run->{memory_growth_kb} || {}}) {
+          push @{$growth{$phase}}, $run->{memory_growth_kb}{$phase};
+        }
+        $solved = 0 if(!$run->{solved} || $run->{signal});
+        print ".";
+      }
+
+      my %entry = (
+        times => \@times,
+        median_time => median(@times),
+        solved => $solved ? JSON::PP::true : JSON::PP::false);
+      $entry{median_iterations} = median(@iterations) if(@iterations);
+      $entry{peak_rss_kb} = (sort { $b <=> $a } @rss)[0] if(@rss);
+      $entry{memory_growth_kb} = { map { $_ => median(@{$growth{$_}}) } keys %growth } if(%growth);
+
+      $results{$name}{$config_name} = \%entry;
+
+      printf(" %.3fs%s\n", $entry{median_time},
+             $solved ? "" : " (unsolved)");
+    }
+  }
+}
+
+open my $OUT, ">$output_file" or die "Cannot write '$output_file': $!";
+print $OUT JSON::PP->new->pretty->canonical->encode(\%results);
+close $OUT;
+print "\nResults written to $output_file\n";
+
+exit 0 if(!defined($baseline_file));
+
+open my $IN, "<$baseline_file" or die "Cannot read baseline '$baseline_file': $!";
+my $baseline = decode_json(do { local $/; <$IN> });
+close $IN;
+
+my $slowdowns = 0;
+my $regressions = 0;
+
+print "\nComparison against $baseline_file:\n";
+
+foreach my $name (sort keys %results) {
+  foreach my $config (sort keys %{$results{$name}}) {
+    my $new = $results{$name}{$config};
+    my $old = $baseline->{$name}{$config};
+    next if(!defined($old));
+
+    if($old->{solved} && !$new->{solved}) {
+      print "  $name [$config]: no longer solved\n";
+      $regressions++;
+      next;
+    }
+
+    my $p = slowdown_p($old->{times}, $new->{times});
+    my $ratio = $new->{median_time} / ($old->{median_time} || 1e-9);
+
+    if($p < $alpha && $ratio - 1 > $threshold) {
+      printf("  %s [%s]: %.3fs -> %.3fs (%+.0f%%, p=%.3f)\n",
+             $name, $config, $old->{median_time}, $new->{median_time},
+             ($ratio - 1) * 100, $p);
+      $slowdowns++;
+    }
+  }
+}
+
+print "  no significant slowdowns\n" if($slowdowns == 0 && $regressions == 0);
+
+exit(($slowdowns || $regressions) ? 1 : 0);
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# Usage: cache.sh fastsynth [options] input
+# Runs fastsynth twice with a fresh cache directory, which misses and then
+# hits the cache, checks that both runs give the same results, and prints
+# the output of the second run.
+
+fastsynth=$1
+shift
+
+cache_dir=$(mktemp -d)
+output_dir=$(mktemp -d)
+trap 'rm -rf "$cache_dir" "$output_dir"' EXIT
+
+"$fastsynth" --cache-dir "$cache_dir" "$@" > "$output_dir/first" 2>&1
+first_exit=$?
+
+"$fastsynth" --cache-dir "$cache_dir" "$@" > "$output_dir/second" 2>&1
+second_exit=$?
+
+if grep -q "^Using cached problem" "$output_dir/first"; then
+  echo "first run used the cache"
+fi
+
+if [ $first_exit -ne $second_exit ] ||
+   ! diff <(grep "^Result:" "$output_dir/first") \
+          <(grep "^Result:" "$output_dir/second") > /dev/null; then
+  echo "results differ"
+fi
+
+cat "$output_dir/second"
+exit $second_exit
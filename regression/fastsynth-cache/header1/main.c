@@ -0,0 +1,15 @@
+#include "values.h"
+
+int EXPRESSIONa(void);
+int EXPRESSIONb(void);
+
+int main()
+{
+  int asd;
+
+  asd=EXPRESSIONa();
+  __CPROVER_assert(asd==VALUE_A, "");
+
+  asd=EXPRESSIONb();
+  __CPROVER_assert(asd==VALUE_B, "");
+}
@@ -0,0 +1,2 @@
+#define VALUE_A 3
+#define VALUE_B 4
@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# Usage: chain.sh fastsynth [options] input
+# Dumps the problem of the input and solves the dumped problem, passing the
+# options to both runs.
+
+fastsynth=$1
+shift
+input="${@: -1}"
+options=("${@:1:$#-1}")
+
+problem=$(mktemp)
+trap 'rm -f "$problem"' EXIT
+
+"$fastsynth" "${options[@]}" --dump-problem "$problem" "$input" || exit $?
+"$fastsynth" "${options[@]}" --load-problem "$problem"
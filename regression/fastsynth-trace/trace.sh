@@ -0,0 +1,21 @@
+#!/bin/bash
+
+# Usage: trace.sh fastsynth [options] input
+# Runs fastsynth with --trace, checks that the trace is valid JSON, and
+# prints the trace after the output of fastsynth.
+
+fastsynth=$1
+shift
+
+trace=$(mktemp)
+trap 'rm -f "$trace"' EXIT
+
+"$fastsynth" --trace "$trace" "$@"
+result=$?
+
+if perl -MJSON::PP -e 'local $/; decode_json(<STDIN>)' < "$trace"; then
+  echo "valid trace JSON"
+fi
+
+cat "$trace"
+exit $result
@@ -1,11 +1,23 @@
 #include <fastsynth/c_frontend.h>
+#include <fastsynth/cegis_options.h>
 #include <fastsynth/literals.h>
+#include <fastsynth/problem_serialization.h>
 #include <fastsynth/symex_problem_factory.h>
+#include <fastsynth/trace.h>
 
 #include <iostream>
+#include <iomanip>
 #include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <chrono>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/stat.h>
+#endif
 
 #include <util/cmdline.h>
 #include <util/cout_message.h>
@@ -15,6 +27,7 @@
 #include <util/mathematical_types.h>
 #include <util/prefix.h>
 #include <util/std_types.h>
+#include <util/version.h>
 
 #include <goto-programs/initialize_goto_model.h>
 #include <goto-programs/goto_convert_functions.h>
@@ -29,6 +42,7 @@
 #include <analyses/guard.h>
 
 #include <ansi-c/ansi_c_language.h>
+#include <ansi-c/c_preprocess.h>
 
 #include <langapi/mode.h>
 #include <langapi/language_util.h>
@@ -114,37 +128,22 @@ void show_formula(
   }
 }
 
-int c_frontend(const cmdlinet &cmdline)
+/// Runs the C front end on the input files: parsing, instrumentation and
+/// symbolic execution.
+/// \return 0 on success
+static int build_problem(
+  const std::vector<std::string> &files,
+  message_handlert &mh,
+  goto_modelt &goto_model,
+  symbol_tablet &new_symbol_table,
+  problemt &problem)
 {
-  console_message_handlert mh;
   messaget message(mh);
 
-  // this is our default verbosity
-  unsigned int v=messaget::M_STATISTICS;
-
-  if(cmdline.isset("verbosity"))
-  {
-    v=std::stol(
-        cmdline.get_value("verbosity"));;
-    if(v>10)
-      v=10;
-  }
-
-  mh.set_verbosity(v);
-
-  register_language(new_ansi_c_language);
-
-  config.set(cmdline);
-  config.ansi_c.set_arch_spec_i386();
-
-  PRECONDITION(cmdline.args.size()==1);
-
-  goto_modelt goto_model;
-
   try
   {
     optionst options;
-    goto_model=initialize_goto_model(cmdline.args, mh, options);
+    goto_model=initialize_goto_model(files, mh, options);
   }
   catch(...)
   {
@@ -162,7 +161,6 @@ int c_frontend(const cmdlinet &cmdline)
   remove_complex(goto_model);
   rewrite_union(goto_model);
 
-  symbol_tablet new_symbol_table;
   namespacet ns(goto_model.symbol_table, new_symbol_table);
   symex_target_equationt equation(mh);
   auto path_storage=get_path_strategy("lifo");
@@ -186,39 +184,240 @@ int c_frontend(const cmdlinet &cmdline)
       return goto_model.get_goto_function(id);
     };
 
-  goto_symex.symex_from_entry_point_of(
-    get_goto_function,
-    new_symbol_table);
+  {
+    trace_scopet trace_scope("symex", "frontend");
+    goto_symex.symex_from_entry_point_of(
+      get_goto_function,
+      new_symbol_table);
+  }
 
   #if 0
   show_formula(equation, ns);
   #endif
 
-  problemt problem = to_problem(mh, options, goto_model);
+  problem = to_problem(mh, ns, equation);
+
+  return 0;
+}
+
+/// Preprocesses the file, which makes the result depend on all headers it
+/// includes and on the preprocessor configuration.
+/// \return the preprocessed text, empty on failure
+static std::string preprocess(
+  const std::string &file_name,
+  message_handlert &mh)
+{
+  std::ostringstream result;
+  if(c_preprocess(file_name, result, mh))
+    return std::string();
+  return result.str();
+}
+
+/// Identifies the build, such that problems cached by other builds, whose
+/// instrumentation or symbolic execution may differ, are not used: the
+/// size and modification time of the executable where known, and the
+/// versions and the compilation time of this file otherwise.
+static std::string build_stamp()
+{
+  std::string result=
+    std::string("fastsynth ")+CBMC_VERSION+' '+__DATE__+' '+__TIME__;
+
+#ifdef __linux__
+  struct stat exe_stat;
+  if(stat("/proc/self/exe", &exe_stat)==0)
+    result+=' '+std::to_string(exe_stat.st_size)+
+            ' '+std::to_string(exe_stat.st_mtime);
+#endif
+
+  return result;
+}
+
+/// Names the cache file of a key by a hash of the key.
+static std::string cache_file_name(
+  const std::string &cache_dir,
+  const std::string &key)
+{
+  // 64-bit FNV-1a, which is stable across runs and platforms
+  std::uint64_t hash=14695981039346656037ull;
+  for(const char c : key)
+  {
+    hash^=static_cast<unsigned char>(c);
+    hash*=1099511628211ull;
+  }
+
+  std::ostringstream result;
+  result << cache_dir << '/' << std::hex << std::setw(16)
+         << std::setfill('0') << hash << ".problem";
+  return result.str();
+}
+
+/// A name for a temporary file next to the given one, unique to this run.
+static std::string temporary_file_name(const std::string &file_name)
+{
+  return file_name+".tmp"+std::to_string(
+    std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+/// Reads the problem cached for the key, if there is one, and the symbols
+/// it refers to. The cache file starts with the key itself, to rule out
+/// hash collisions.
+/// \return true if the problem was read
+static bool read_cached_problem(
+  const std::string &cache_file,
+  const std::string &key,
+  symbol_tablet &symbol_table,
+  problemt &problem)
+{
+  std::ifstream in(cache_file, std::ios::binary);
+  if(!in)
+    return false;
+
+  std::string cached_key(key.size(), '\0');
+  if(!in.read(&cached_key[0], cached_key.size()) || cached_key!=key)
+    return false;
+
+  std::string logic;
+  symbol_tablet symbols;
+  if(!read_problem(in, problem, logic, symbols))
+    return false;
+
+  symbol_table.swap(symbols);
+  return true;
+}
+
+/// Stores the problem for the key, with the symbols it refers to. The
+/// file is written under a temporary name and then renamed, hence
+/// concurrent runs never see a partial one.
+static void write_cached_problem(
+  const std::string &cache_file,
+  const std::string &key,
+  const namespacet &ns,
+  const problemt &problem,
+  messaget &message)
+{
+  symbol_tablet symbols;
+  collect_problem_symbols(ns, problem, symbols);
+
+  const std::string tmp_file=temporary_file_name(cache_file);
+
+  {
+    std::ofstream out(tmp_file, std::ios::binary);
+    out << key;
+    write_problem(out, problem, "BV", symbols);
+
+    if(!out)
+    {
+      message.warning() << "failed to write cache file " << tmp_file
+                        << messaget::eom;
+      return;
+    }
+  }
+
+  if(std::rename(tmp_file.c_str(), cache_file.c_str())!=0)
+  {
+    message.warning() << "failed to write cache file " << cache_file
+                      << messaget::eom;
+    std::remove(tmp_file.c_str());
+  }
+}
+
+int c_frontend(const cmdlinet &cmdline)
+{
+  console_message_handlert mh;
+  messaget message(mh);
+
+  // this is our default verbosity
+  unsigned int v=messaget::M_STATISTICS;
+
+  if(cmdline.isset("verbosity"))
+  {
+    v=std::stol(
+        cmdline.get_value("verbosity"));;
+    if(v>10)
+      v=10;
+  }
+
+  mh.set_verbosity(v);
+
+  register_language(new_ansi_c_language);
+
+  config.set(cmdline);
+  config.ansi_c.set_arch_spec_i386();
+
+  PRECONDITION(cmdline.args.size()==1);
+
+  goto_modelt goto_model;
+  symbol_tablet new_symbol_table;
+  namespacet ns(goto_model.symbol_table, new_symbol_table);
+  problemt problem;
+
+  // the cache is keyed on the build and the preprocessed input, hence
+  // headers count
+  std::string source, key, cache_file;
+  if(cmdline.isset("cache-dir"))
+  {
+    source=preprocess(cmdline.args.front(), mh);
+    if(source.empty())
+      message.warning() << "not caching, preprocessing failed"
+                        << messaget::eom;
+    else
+    {
+      key=build_stamp()+'\n'+source;
+      cache_file=cache_file_name(cmdline.get_value("cache-dir"), key);
+    }
+  }
+
+  if(!cache_file.empty() &&
+     read_cached_problem(cache_file, key, goto_model.symbol_table, problem))
+  {
+    message.status() << "Using cached problem " << cache_file
+                     << messaget::eom;
+  }
+  else
+  {
+    // the front end does not preprocess .i files, hence the source is
+    // preprocessed once
+    std::vector<std::string> files=cmdline.args;
+    std::string preprocessed_file;
+    if(!cache_file.empty())
+    {
+      preprocessed_file=temporary_file_name(cache_file)+".i";
+      std::ofstream out(preprocessed_file, std::ios::binary);
+      out << source;
+      if(out)
+        files={preprocessed_file};
+    }
+
+    const int result=
+      build_problem(files, mh, goto_model, new_symbol_table, problem);
+
+    if(!preprocessed_file.empty())
+      std::remove(preprocessed_file.c_str());
+
+    if(result!=0)
+      return result;
+
+    if(!cache_file.empty())
+      write_cached_problem(cache_file, key, ns, problem, message);
+  }
   if(cmdline.isset("literals"))
     add_literals(problem);
 
+  if(cmdline.isset("dump-problem"))
+  {
+    if(!write_problem_file(
+         cmdline.get_value("dump-problem"), ns, problem, "BV"))
+    {
+      message.error() << "Failed to write problem file" << messaget::eom;
+      return 1;
+    }
+    return 0;
+  }
+
   cegist cegis(ns);
   cegis.set_message_handler(mh);
 
-  if(cmdline.isset("max-program-size"))
-    cegis.max_program_size=std::stol(
-      cmdline.get_value("max-program-size"));
-  else
-    cegis.max_program_size=5; // default
-
-  if(cmdline.isset("min-program-size"))
-    cegis.min_program_size=std::stol(cmdline.get_value("min-program-size"));
-  else
-    cegis.min_program_size=1; // default
-
-  cegis.incremental_solving=cmdline.isset("incremental");
-  cegis.use_simp_solver=cmdline.isset("simplifying-solver");
-  cegis.use_fm=cmdline.isset("fm");
-  cegis.use_local_search=cmdline.isset("local-search");
-  cegis.enable_bitwise=!cmdline.isset("no-bitwise");\
-  cegis.use_smt=cmdline.isset("smt");
-  cegis.enable_division=cmdline.isset("enable-division");
+  set_cegis_options(cmdline, cegis);
   cegis.logic="BV"; //default logic
 
   auto start_time=std::chrono::steady_clock::now();
@@ -243,6 +442,14 @@ int c_frontend(const cmdlinet &cmdline)
                               std::chrono::steady_clock::now()-start_time).count()
                          << 's'
                          << messaget::eom;
+
+    message.statistics() << "Synthesis solver: "
+                         << cegis.synthesis_statistics
+                         << messaget::eom;
+
+    message.statistics() << "Verification solver: "
+                         << cegis.verification_statistics
+                         << messaget::eom;
     break;
 
   case decision_proceduret::resultt::D_UNSATISFIABLE:
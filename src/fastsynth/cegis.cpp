@@ -2,8 +2,11 @@
 #include "incremental_solver_learn.h"
 #include "local_cegis.h"
 #include "solver_learn.h"
+#include "stochastic_search.h"
 #include "verify.h"
 #include "fm_verify.h"
+#include "memory_statistics.h"
+#include "trace.h"
 #include <chrono>
 
 #include <langapi/language_util.h>
@@ -18,6 +21,9 @@ decision_proceduret::resultt cegist::operator()(
   std::unique_ptr<learnt> learner;
   std::unique_ptr<verifyt> verifier;
 
+  // everything up to here belongs to parsing and symex
+  global_memory_phases().end_phase("frontend");
+
   if((incremental_solving || use_simp_solver) && use_smt)
   {
     warning() << "WARNING: unable to use smt back end and incremental solving together\n"
@@ -53,10 +59,18 @@ decision_proceduret::resultt cegist::operator()(
 
   learner->enable_bitwise=enable_bitwise;
 
+  if(use_stochastic_search)
+  {
+    status() << "** stochastic search before synthesis" << eom;
+    learner=std::unique_ptr<learnt>(new stochastic_learnt(
+      ns, problem, std::move(learner), get_message_handler()));
+  }
+
   if(use_fm)
   {
-    verifier=std::unique_ptr<verifyt>(new fm_verifyt(
-      ns, problem, get_message_handler()));
+    fm_verifyt *v=new fm_verifyt(ns, problem, get_message_handler());
+    v->fm_options=fm_options;
+    verifier=std::unique_ptr<verifyt>(v);
   }
   else
   {
@@ -67,7 +81,13 @@ decision_proceduret::resultt cegist::operator()(
   verifier->use_smt=use_smt;
   verifier->logic=logic;
 
-  return loop(problem, *learner, *verifier);
+  const decision_proceduret::resultt result=
+    loop(problem, *learner, *verifier);
+
+  global_memory_phases().output(statistics());
+  statistics() << eom;
+
+  return result;
 }
 
 decision_proceduret::resultt cegist::loop(
@@ -81,6 +101,9 @@ decision_proceduret::resultt cegist::loop(
   local_cegis.use_simp_solver = use_simp_solver;
   local_cegis.use_smt = use_smt;
   local_cegis.logic = logic;
+  local_cegis.jobs = local_search_jobs;
+  local_cegis.max_learners = local_search_learners;
+  local_cegis.use_constant_synthesis = use_constant_synthesis;
 
   unsigned iteration=0;
 
@@ -97,6 +120,10 @@ decision_proceduret::resultt cegist::loop(
       return decision_proceduret::resultt::D_SATISFIABLE;
     }
 
+    // counterexamples found by concurrent local searches
+    for(const auto &ce : local_cegis.take_counterexamples())
+      learn.add_ce(ce);
+
     iteration++;
     status() << blue << "** CEGIS iteration " << iteration << reset << eom;
     auto iter_start_time=std::chrono::steady_clock::now();
@@ -108,7 +135,24 @@ decision_proceduret::resultt cegist::loop(
 
     learn.set_program_size(program_size);
 
-    switch(learn())
+    decision_proceduret::resultt learn_result;
+
+    {
+      trace_scopet trace_scope("synthesis", "cegis");
+      learn_result=learn();
+    }
+
+    global_memory_phases().end_phase(memory_phase_prefix+"synthesis");
+
+    statistics() << "Synthesis solver iteration " << iteration << ": "
+                 << learn.solver_statistics << eom;
+    synthesis_statistics+=learn.solver_statistics;
+
+    if(!learn.expression_statistics.empty())
+      statistics() << "Synthesis expressions iteration " << iteration << ": "
+                   << learn.expression_statistics << eom;
+
+    switch(learn_result)
     {
     case decision_proceduret::resultt::D_SATISFIABLE: // got candidate
       {
@@ -151,7 +195,20 @@ decision_proceduret::resultt cegist::loop(
              << 's' << eom;
     status() << "** Verification phase" << eom;
 
-    switch(verify(solution))
+    decision_proceduret::resultt verify_result;
+
+    {
+      trace_scopet trace_scope("verification", "cegis");
+      verify_result=verify(solution);
+    }
+
+    global_memory_phases().end_phase(memory_phase_prefix+"verification");
+
+    statistics() << "Verification solver iteration " << iteration << ": "
+                 << verify.solver_statistics << eom;
+    verification_statistics+=verify.solver_statistics;
+
+    switch(verify_result)
     {
     case decision_proceduret::resultt::D_SATISFIABLE: // counterexample
       status() << "** Verification failed" << eom;
@@ -162,10 +219,27 @@ decision_proceduret::resultt cegist::loop(
                << 's' << eom;
 
       learn.add_ce(verify.get_counterexample());
+      if(record_counterexamples)
+        counterexamples.push_back(verify.get_counterexample());
       if(use_local_search)
       {
+        trace_scopet trace_scope("local search", "cegis");
+        local_cegis.share_counterexample(verify.get_counterexample());
         local_cegis.push_back(solution, program_size);
         local_cegis();
+
+        global_memory_phases().end_phase("local search");
+
+        if(get_message_handler().get_verbosity()>=M_STATISTICS)
+        {
+          statistics() << "Local search: "
+                       << local_cegis.number_of_neighbourhoods()
+                       << " neighbourhoods, "
+                       << local_cegis.number_of_learners() << " learners, "
+                       << local_cegis.expression_statistics() << eom;
+          statistics() << "Local search limits solver: "
+                       << local_cegis.solver_statistics << eom;
+        }
       }
       break;
 
@@ -6,6 +6,8 @@
 #include <util/message.h>
 
 #include "cegis_types.h"
+#include "fm_matrix.h"
+#include "solver_statistics.h"
 
 class synth_encodingt;
 class verify_encodingt;
@@ -24,11 +26,16 @@ public:
     incremental_solving(false),
     use_simp_solver(false),
     use_local_search(false),
+    local_search_jobs(0),
+    local_search_learners(0),
+    use_stochastic_search(false),
+    use_constant_synthesis(false),
     use_fm(false),
     enable_bitwise(false),
     enable_division(false),
     use_smt(false),
     logic("BV"),
+    record_counterexamples(false),
     ns(_ns)
   {
   }
@@ -43,12 +50,39 @@ public:
   bool incremental_solving;
   bool use_simp_solver;
   bool use_local_search;
+
+  /// Number of processes exploring neighbourhoods concurrently with the
+  /// loop, see local_cegist::jobs.
+  std::size_t local_search_jobs;
+
+  /// Limit on the neighbourhood learners kept, see
+  /// local_cegist::max_learners.
+  std::size_t local_search_learners;
+
+  /// Try a stochastic_searcht from the last candidate before asking the
+  /// learner for the next one, see stochastic_learnt.
+  bool use_stochastic_search;
+
+  /// \see local_cegist::use_constant_synthesis
+  bool use_constant_synthesis;
   bool use_fm;
+  fm_optionst fm_options;
   bool enable_bitwise;
   bool enable_division;
   bool use_smt;
   std::string logic; // used by smt
 
+  /// Solver statistics accumulated over all iterations.
+  solver_statisticst synthesis_statistics, verification_statistics;
+
+  /// Prepended to the phase names used for memory accounting, to separate
+  /// nested loops, e.g. of the local search.
+  std::string memory_phase_prefix;
+
+  /// Keep the counterexamples found by the loop in counterexamples.
+  bool record_counterexamples;
+  std::vector<counterexamplet> counterexamples;
+
 protected:
   const namespacet &ns;
 
@@ -0,0 +1,37 @@
+#include "cegis_options.h"
+#include "cegis.h"
+
+void set_cegis_options(const cmdlinet &cmdline, cegist &cegis)
+{
+  if(cmdline.isset("max-program-size"))
+    cegis.max_program_size=std::stol(
+      cmdline.get_value("max-program-size"));
+  else
+    cegis.max_program_size=5; // default
+
+  if(cmdline.isset("min-program-size"))
+    cegis.min_program_size=std::stol(cmdline.get_value("min-program-size"));
+  else
+    cegis.min_program_size=1; // default
+
+  cegis.incremental_solving=cmdline.isset("incremental");
+  cegis.use_simp_solver=cmdline.isset("simplifying-solver");
+  cegis.use_fm=cmdline.isset("fm");
+  cegis.fm_options.presolve=cmdline.isset("fm-presolve");
+  cegis.fm_options.chernikov=!cmdline.isset("fm-no-chernikov");
+  cegis.fm_options.lp_redundancy=cmdline.isset("fm-lp-redundancy");
+  if(cmdline.isset("fm-threads"))
+    cegis.fm_options.threads=std::stoul(cmdline.get_value("fm-threads"));
+  cegis.use_local_search=cmdline.isset("local-search");
+  if(cmdline.isset("local-search-jobs"))
+    cegis.local_search_jobs=std::stoul(
+      cmdline.get_value("local-search-jobs"));
+  cegis.use_stochastic_search=cmdline.isset("stochastic-search");
+  cegis.use_constant_synthesis=cmdline.isset("constant-synthesis");
+  if(cmdline.isset("local-search-learners"))
+    cegis.local_search_learners=std::stoul(
+      cmdline.get_value("local-search-learners"));
+  cegis.enable_bitwise=!cmdline.isset("no-bitwise");
+  cegis.use_smt=cmdline.isset("smt");
+  cegis.enable_division=cmdline.isset("enable-division");
+}
@@ -0,0 +1,12 @@
+#ifndef CPROVER_FASTSYNTH_CEGIS_OPTIONS_H_
+#define CPROVER_FASTSYNTH_CEGIS_OPTIONS_H_
+
+#include <util/cmdline.h>
+
+class cegist;
+
+/// Configures the CEGIS loop from the command-line options shared by all
+/// front ends. The logic is left to the front end.
+void set_cegis_options(const cmdlinet &, cegist &);
+
+#endif /* CPROVER_FASTSYNTH_CEGIS_OPTIONS_H_ */
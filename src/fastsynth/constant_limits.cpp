@@ -1,8 +1,7 @@
 #include <fastsynth/constant_limits.h>
 #include <fastsynth/cegis.h>
 #include <fastsynth/local_synth_encoding.h>
-
-#include <solvers/smt2/smt2_dec.h>
+#include <fastsynth/trace.h>
 
 #include <langapi/language_util.h>
 
@@ -85,10 +84,12 @@ find_program_vars(const exprt::operandst &ops, const std::set<exprt> &free_vars)
   return result;
 }
 
-decision_proceduret::resultt constant_limitst::decide(
-  const synth_encodingt::constraintst &additional_constraints)
+void constant_limitst::encode()
 {
-  local_synth_encodingt encoding(ns, solution_template, additional_constraints);
+  trace_scopet trace_scope("constant_limits encoding", "local search");
+  encoding = std::unique_ptr<local_synth_encodingt>(
+    new local_synth_encodingt(ns, solution_template, no_constraints));
+  local_synth_encodingt &encoding = *this->encoding;
   encoding.suffix = "$ce";
   encoding.constraints.clear();
 
@@ -158,12 +159,28 @@ decision_proceduret::resultt constant_limitst::decide(
 
   std::string notes("Generated by CBMC ");
   notes += CBMC_VERSION;
-  smt2_dect prop_conv(ns, "cbmc", notes, "", smt2_dect::solvert::Z3);
-  prop_conv.set_message_handler(get_message_handler());
-  prop_conv.set_to_true(constraint);
+  solver = std::unique_ptr<smt2_dect>(
+    new smt2_dect(ns, "cbmc", notes, "", smt2_dect::solvert::Z3));
+  solver->set_message_handler(get_message_handler());
+  solver->set_to_true(constraint);
+}
+
+decision_proceduret::resultt constant_limitst::decide(
+  const synth_encodingt::constraintst &additional_constraints)
+{
+  if(!solver)
+    encode();
+
+  trace_scopet trace_scope("constant_limits query", "local search");
+  smt2_dect &prop_conv = *solver;
+
+  const exprt::operandst limits(
+    begin(additional_constraints), end(additional_constraints));
+  prop_conv.set_assumptions({prop_conv.convert(conjunction(limits))});
 
   solutiont::functionst &functions = solution.functions;
-  const decision_proceduret::resultt result = prop_conv();
+  const decision_proceduret::resultt result =
+    ::solve(prop_conv, nullptr, solver_statistics);
   switch(result)
   {
   case decision_proceduret::resultt::D_UNSATISFIABLE:
@@ -184,7 +201,7 @@ decision_proceduret::resultt constant_limitst::decide(
   case decision_proceduret::resultt::D_SATISFIABLE:
     status() << "VERIFICATION SUCCESSFUL\n";
     debug() << "SMT sat, have solution:\n";
-    solution = encoding.get_solution(prop_conv);
+    solution = encoding->get_solution(prop_conv);
     for(std::pair<const symbol_exprt, exprt> &expression : functions)
     {
       exprt &value = expression.second;
@@ -241,6 +258,7 @@ public:
 decision_proceduret::resultt constant_limitst::
 operator()(const solutiont &candidate)
 {
+  trace_scopet trace_scope("constant_limits", "local search");
   const solutiont::functionst &functions = candidate.functions;
   debug() << "Testing constants:\n";
   output_expressions(functions, ns, debug());
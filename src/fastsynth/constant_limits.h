@@ -1,10 +1,16 @@
 #ifndef CPROVER_FASTSYNTH_CONSTANT_LIMITS_H_
 #define CPROVER_FASTSYNTH_CONSTANT_LIMITS_H_
 
+#include <fastsynth/local_synth_encoding.h>
+#include <fastsynth/solver_statistics.h>
 #include <fastsynth/synth_encoding.h>
 
+#include <solvers/smt2/smt2_dec.h>
+
 #include <util/message.h>
 
+#include <memory>
+
 /// Employs an SMT solver to quickly test whether a solution using constants
 /// above or below certain values are feasible.
 class constant_limitst : public messaget
@@ -18,6 +24,20 @@ class constant_limitst : public messaget
   /// Solution template used to construct local encodings.
   const solutiont &solution_template;
 
+  /// Extra constraints of the base encoding, which has none.
+  const synth_encodingt::constraintst no_constraints;
+
+  /// Local encoding of the template, shared by all queries.
+  std::unique_ptr<local_synth_encodingt> encoding;
+
+  /// Solver holding the quantified base formula, shared by all queries.
+  std::unique_ptr<smt2_dect> solver;
+
+  /// Encodes the quantified problem for the template once. The constraints
+  /// of the queries only mention the constants, which are free, hence can
+  /// be added outside of the quantifiers as assumptions.
+  void encode();
+
   /// Performs a limited synthesis SMT query.
   /// \param additional_constraints Additional constraints. Usually restricts
   ///   local search to only certain constants.
@@ -33,6 +53,9 @@ public:
   /// On the off chance that SMT actually just finds a solution.
   solutiont solution;
 
+  /// Statistics of the SMT queries.
+  solver_statisticst solver_statistics;
+
   /// Constructs and automatically starts a constant_limitst dispatch handler.
   /// \param msg Message sink to use for progress messages.
   /// \param ns \see constant_limitst::ns
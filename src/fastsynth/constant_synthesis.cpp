@@ -0,0 +1,220 @@
+#include <fastsynth/constant_synthesis.h>
+#include <fastsynth/local_synth_encoding.h>
+#include <fastsynth/solver.h>
+#include <fastsynth/trace.h>
+
+#include <util/mathematical_types.h>
+#include <util/std_types.h>
+
+#include <memory>
+
+namespace
+{
+/// Finds constants of the given type in visitation order, which is the
+/// order in which `local_synth_encodingt` numbers its `_cval` symbols.
+class find_constantst : public const_expr_visitort
+{
+  const typet &word_type;
+
+public:
+  explicit find_constantst(const typet &word_type)
+    : word_type(word_type), count(0)
+  {
+  }
+
+  /// Number of constants found.
+  std::size_t count;
+
+  /// \see const_expr_visitort::operator()(const exprt &)
+  void operator()(const exprt &expr) override
+  {
+    if(ID_constant == expr.id() && expr.type() == word_type)
+      ++count;
+  }
+};
+}
+
+/// Like local_synth_encoding, but the factory owns copies of the template
+/// and constraints, since the learner may outlive the caller's.
+static synth_encoding_factoryt owning_local_synth_encoding(
+  const namespacet &ns,
+  const solutiont &solution_template,
+  const synth_encodingt::constraintst &constraints)
+{
+  const auto solution = std::make_shared<const solutiont>(solution_template);
+  const auto extra_constraints =
+    std::make_shared<const synth_encodingt::constraintst>(constraints);
+
+  return [&ns, solution, extra_constraints]() {
+    return std::unique_ptr<synth_encodingt>(
+      new local_synth_encodingt(ns, *solution, *extra_constraints));
+  };
+}
+
+constant_synthesist::constant_synthesist(
+  const namespacet &ns,
+  const problemt &problem,
+  const solutiont &solution_template,
+  const synth_encodingt::constraintst &constraints,
+  message_handlert &message_handler)
+  : solver_learn_baset(
+      ns,
+      problem,
+      message_handler,
+      owning_local_synth_encoding(ns, solution_template, constraints)),
+    narrow_intervals(true),
+    fix_bits(true),
+    satcheck(new_satcheck_no_simplifier(message_handler)),
+    solver(new bv_pointerst(ns, *satcheck, message_handler)),
+    encoding(synth_encoding_factory()),
+    counterexample_counter(0)
+{
+  for(const auto &function : solution_template.functions)
+  {
+    const auto &signature =
+      to_mathematical_function_type(function.first.type());
+
+    // the word type local_synth_encodingt gives the constants
+    e_datat e_data;
+    e_data.return_type = signature.codomain();
+    for(const auto &parameter : signature.domain())
+      e_data.parameter_types.push_back(parameter);
+    const typet word_type = e_data.compute_word_type();
+
+    find_constantst find_constants(word_type);
+    function.second.visit(find_constants);
+
+    const irep_idt &identifier = function.first.get_identifier();
+    for(std::size_t i = 0; i < find_constants.count; ++i)
+      constants.push_back(cval(identifier, i, word_type));
+  }
+
+  // base problem, which also fixes the word type of the encoding
+  add_problem(*encoding, *solver);
+}
+
+void constant_synthesist::add_ce(const counterexamplet &counterexample)
+{
+  encoding->constraints.clear();
+  encoding->suffix = "$ce" + std::to_string(counterexample_counter++);
+
+  add_counterexample(counterexample, *encoding, *solver);
+  add_problem(*encoding, *solver);
+}
+
+decision_proceduret::resultt
+constant_synthesist::solve_under(const bvt &assumptions)
+{
+  satcheck->set_assumptions(assumptions);
+  return ::solve(*solver, satcheck.get(), solver_statistics);
+}
+
+decision_proceduret::resultt constant_synthesist::narrow()
+{
+  trace_scopet trace_scope("interval narrowing", "constant synthesis");
+
+  for(const symbol_exprt &constant : constants)
+  {
+    const exprt value = solver->get(constant);
+    if(value.is_nil())
+      continue;
+
+    bool have_model = true;
+
+    for(const irep_idt &relation : {ID_lt, ID_gt})
+    {
+      const binary_relation_exprt beyond(constant, relation, value);
+      const literalt l = solver->convert(beyond);
+
+      switch(solve_under({l}))
+      {
+      case decision_proceduret::resultt::D_UNSATISFIABLE:
+        // infeasible for these counterexamples, hence for all
+        debug() << "Narrowing: " << constant.get_identifier()
+                << (relation == ID_lt ? " >= " : " <= ")
+                << to_constant_expr(value).get_value() << eom;
+        solver->set_to_false(beyond);
+        have_model = false;
+        break;
+      case decision_proceduret::resultt::D_SATISFIABLE:
+        break;
+      case decision_proceduret::resultt::D_ERROR:
+        have_model = false;
+      }
+    }
+
+    // the value itself is still feasible, unless the solver failed
+    if(!have_model)
+    {
+      const decision_proceduret::resultt result = solve_under({});
+      if(result != decision_proceduret::resultt::D_SATISFIABLE)
+        return result;
+    }
+  }
+
+  return decision_proceduret::resultt::D_SATISFIABLE;
+}
+
+decision_proceduret::resultt constant_synthesist::fix()
+{
+  trace_scopet trace_scope("bit fixing", "constant synthesis");
+
+  bvt assumptions;
+
+  for(const symbol_exprt &constant : constants)
+  {
+    const typet &type = constant.type();
+    if(type.id() != ID_signedbv && type.id() != ID_unsignedbv)
+      continue;
+
+    // most significant bit first
+    for(std::size_t i = to_bitvector_type(type).get_width(); i-- > 0;)
+    {
+      const literalt bit = solver->convert(extractbit_exprt(constant, i));
+
+      if(solver->l_get(bit).is_false())
+      {
+        assumptions.push_back(!bit);
+        continue;
+      }
+
+      assumptions.push_back(!bit);
+      if(
+        solve_under(assumptions) ==
+        decision_proceduret::resultt::D_SATISFIABLE)
+      {
+        continue;
+      }
+
+      // the previous model has the bit set, unless the solver failed
+      assumptions.back() = bit;
+      const decision_proceduret::resultt result = solve_under(assumptions);
+      if(result != decision_proceduret::resultt::D_SATISFIABLE)
+        return result;
+    }
+  }
+
+  return decision_proceduret::resultt::D_SATISFIABLE;
+}
+
+decision_proceduret::resultt constant_synthesist::operator()()
+{
+  trace_scopet trace_scope("SAT solving", "constant synthesis");
+  solver_statistics.clear();
+  update_expression_statistics();
+
+  decision_proceduret::resultt result = solve_under({});
+
+  if(result == decision_proceduret::resultt::D_SATISFIABLE && narrow_intervals)
+    result = narrow();
+
+  if(result == decision_proceduret::resultt::D_SATISFIABLE && fix_bits)
+    result = fix();
+
+  return result;
+}
+
+solutiont constant_synthesist::get_solution() const
+{
+  return encoding->get_solution(*solver);
+}
@@ -0,0 +1,83 @@
+#ifndef CPROVER_FASTSYNTH_CONSTANT_SYNTHESIS_H_
+#define CPROVER_FASTSYNTH_CONSTANT_SYNTHESIS_H_
+
+#include <fastsynth/solver_learn.h>
+#include <fastsynth/synth_encoding.h>
+
+#include <solvers/flattening/bv_pointers.h>
+#include <solvers/prop/prop.h>
+
+#include <memory>
+
+/// Learner for the constants of a fixed solution template. The constants
+/// are the only unknowns, encoded as `_cval` symbols by
+/// local_synth_encodingt, and the counterexamples are bit-blasted
+/// incrementally into a single SAT instance. Each candidate is improved
+/// before it is returned:
+///  - interval narrowing: for each constant c with value v, c < v and c > v
+///    are tried under assumptions, and the bound is made permanent if one
+///    is infeasible for the counterexamples seen so far;
+///  - bit fixing: the bits of each constant are fixed from the most
+///    significant one, preferring zero, which favours small constants.
+/// Unlike constant_limitst, this needs no quantified SMT query.
+class constant_synthesist : public solver_learn_baset
+{
+public:
+  /// Creates a learner for the constants of the given template.
+  /// \param ns \see solver_learn_baset::ns
+  /// \param problem \see solver_learn_baset::problem
+  /// \param solution_template Solution whose constants to synthesise.
+  /// \param constraints Additional constraints on the constants.
+  /// \param message_handler \see messaget::messaget(message_handlert &)
+  constant_synthesist(
+    const namespacet &ns,
+    const problemt &problem,
+    const solutiont &solution_template,
+    const synth_encodingt::constraintst &constraints,
+    message_handlert &message_handler);
+
+  /// The template is fixed, hence the size is ignored.
+  void set_program_size(size_t) override
+  {
+  }
+
+  /// \see learnt::operator()()
+  decision_proceduret::resultt operator()() override;
+
+  /// \see learnt::get_solution()
+  solutiont get_solution() const override;
+
+  /// \see learnt::add_ce(const counterexamplet &)
+  void add_ce(const counterexamplet &) override;
+
+  /// Whether to narrow the intervals of the constants.
+  bool narrow_intervals;
+
+  /// Whether to fix the bits of the constants.
+  bool fix_bits;
+
+protected:
+  std::unique_ptr<propt> satcheck;
+  std::unique_ptr<bv_pointerst> solver;
+  std::unique_ptr<synth_encodingt> encoding;
+
+  /// The `_cval` symbols of the template.
+  std::vector<symbol_exprt> constants;
+
+  /// Number of counterexamples added.
+  std::size_t counterexample_counter;
+
+  /// Solves under the given assumptions.
+  decision_proceduret::resultt solve_under(const bvt &assumptions);
+
+  /// Makes c >= v or c <= v permanent where the opposite is infeasible.
+  /// \return result of the last solver call, which leaves a model if
+  ///   satisfiable
+  decision_proceduret::resultt narrow();
+
+  /// Fixes the bits of all constants, keeping the solver satisfiable.
+  /// \return result of the last solver call, \see narrow()
+  decision_proceduret::resultt fix();
+};
+
+#endif /* CPROVER_FASTSYNTH_CONSTANT_SYNTHESIS_H_ */
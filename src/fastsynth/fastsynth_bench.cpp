@@ -0,0 +1,466 @@
+/*******************************************************************
+
+ Module: Microbenchmarks for the hot paths of fastsynth
+
+\*******************************************************************/
+
+#include "fourier_motzkin.h"
+#include "sygus_parser.h"
+#include "synth_encoding.h"
+#include "verify_encoding.h"
+
+#include <util/arith_tools.h>
+#include <util/cmdline.h>
+#include <util/config.h>
+#include <util/message.h>
+#include <util/namespace.h>
+#include <util/symbol_table.h>
+
+#include <ansi-c/ansi_c_language.h>
+
+#include <langapi/mode.h>
+
+#include <solvers/sat/satcheck.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#define FASTSYNTH_BENCH_OPTIONS \
+  "(filter):" \
+  "(min-time):" \
+  "(repetitions):"
+
+/// A named microbenchmark. The body runs the measured operation the given
+/// number of times; the runner calibrates that number.
+struct benchmarkt
+{
+  std::string name;
+  std::function<void(std::size_t iterations)> body;
+};
+
+using benchmarkst=std::vector<benchmarkt>;
+
+/// Keeps the optimiser from discarding a computed value.
+template <typename T>
+static void do_not_optimize(const T &value)
+{
+  static const void *volatile sink;
+  sink=&value;
+}
+
+static const namespacet &bench_namespace()
+{
+  static symbol_tablet symbol_table;
+  static namespacet ns(symbol_table);
+  return ns;
+}
+
+static function_application_exprt synth_fun_application(
+  const typet &word_type,
+  const exprt::operandst &arguments)
+{
+  mathematical_function_typet::domaint domain;
+  for(const auto &a : arguments)
+    domain.push_back(a.type());
+
+  const mathematical_function_typet type(domain, word_type);
+
+  return function_application_exprt(
+    symbol_exprt("synth_fun::f", type), arguments, word_type);
+}
+
+/// Specification f(x, y) >= x && f(x, y) >= y over the given word type.
+static exprt max_constraint(const typet &word_type)
+{
+  const symbol_exprt x("x", word_type), y("y", word_type);
+  const auto f=synth_fun_application(word_type, {x, y});
+
+  return and_exprt(
+    binary_predicate_exprt(f, ID_ge, x),
+    binary_predicate_exprt(f, ID_ge, y));
+}
+
+static void e_data_benchmarks(benchmarkst &dest)
+{
+  const std::vector<std::pair<std::string, typet>> word_types=
+  {
+    { "unsignedbv8", unsignedbv_typet(8) },
+    { "unsignedbv32", unsignedbv_typet(32) },
+    { "signedbv64", signedbv_typet(64) },
+    { "integer", integer_typet() }
+  };
+
+  for(const auto &w : word_types)
+    for(std::size_t program_size=1; program_size<=8; program_size++)
+    {
+      const typet word_type=w.second;
+      const auto application=synth_fun_application(
+        word_type,
+        { symbol_exprt("x", word_type), symbol_exprt("y", word_type) });
+
+      dest.push_back(
+      {
+        "e_data/"+w.first+"/size:"+std::to_string(program_size),
+        [application, program_size](std::size_t iterations)
+        {
+          for(std::size_t i=0; i<iterations; i++)
+          {
+            e_datat e_data;
+            exprt result=e_data(application, program_size, true, false);
+            do_not_optimize(result);
+          }
+        }
+      });
+    }
+}
+
+static void synth_encoding_benchmarks(benchmarkst &dest)
+{
+  const unsignedbv_typet word_type(32);
+  const exprt constraint=max_constraint(word_type);
+
+  for(const std::size_t counterexamples : { 1, 10, 100 })
+  {
+    dest.push_back(
+    {
+      "synth_encoding/ce:"+std::to_string(counterexamples),
+      [constraint, counterexamples](std::size_t iterations)
+      {
+        for(std::size_t i=0; i<iterations; i++)
+        {
+          synth_encodingt synth_encoding;
+          synth_encoding.program_size=3;
+          synth_encoding.enable_bitwise=true;
+
+          for(std::size_t ce=0; ce<counterexamples; ce++)
+          {
+            synth_encoding.suffix="$ce"+std::to_string(ce);
+            synth_encoding.constraints.clear();
+            exprt result=synth_encoding(constraint);
+            do_not_optimize(result);
+          }
+        }
+      }
+    });
+  }
+}
+
+static void verify_encoding_benchmarks(benchmarkst &dest)
+{
+  const unsignedbv_typet word_type(32);
+  const exprt constraint=max_constraint(word_type);
+
+  for(const std::size_t depth : { 1, 4, 16 })
+  {
+    // body: nested max over the parameters
+    const symbol_exprt p0("synth::parameter0", word_type);
+    const symbol_exprt p1("synth::parameter1", word_type);
+    exprt body=p0;
+    for(std::size_t d=0; d<depth; d++)
+      body=if_exprt(binary_predicate_exprt(body, ID_ge, p1), body, p1);
+
+    verify_encodingt verify_encoding;
+    verify_encoding.functions[to_symbol_expr(
+      synth_fun_application(word_type, { p0, p1 }).function())]=body;
+
+    dest.push_back(
+    {
+      "verify_encoding/depth:"+std::to_string(depth),
+      [verify_encoding, constraint](std::size_t iterations)
+      {
+        for(std::size_t i=0; i<iterations; i++)
+        {
+          exprt result=verify_encoding(constraint);
+          do_not_optimize(result);
+        }
+      }
+    });
+  }
+}
+
+namespace
+{
+/// Helper class to access protected fourier_motzkint operations.
+class fm_accessort:public fourier_motzkint
+{
+public:
+  fm_accessort(const namespacet &_ns, propt &_prop, message_handlert &mh):
+    fourier_motzkint(_ns, _prop, mh)
+  {
+  }
+
+  /// Eliminates the given variables from the given inequalities.
+  /// \return false if the system is found to be inconsistent
+  bool eliminate_all(
+    const std::vector<exprt> &inequalities,
+    const std::vector<exprt> &variables)
+  {
+    std::vector<linear_formt> forms;
+
+    for(const auto &i : inequalities)
+    {
+      linear_formt form;
+      if(get_linear_form(i, form))
+        forms.push_back(form);
+    }
+
+    fm_projectiont projection(new_matrix());
+    for(const auto &f : forms)
+      add_row(projection.rows, f, false);
+
+    for(const auto &x : variables)
+    {
+      const auto column_it=column_numbers.find(x);
+      if(column_it!=column_numbers.end())
+        projection.existential_columns.push_back(column_it->second);
+    }
+
+    fm_project(projection, options);
+    return projection.is_consistent;
+  }
+};
+}
+
+/// Random system of inequalities of the form +-x_i +-x_j +-x_k <= c.
+static std::vector<exprt> fm_row_system(
+  std::size_t number_of_variables,
+  std::size_t number_of_rows,
+  std::vector<exprt> &variables)
+{
+  std::mt19937 generator(number_of_variables*1000+number_of_rows);
+  std::uniform_int_distribution<std::size_t> variable_distribution(
+    0, number_of_variables-1);
+  std::uniform_int_distribution<int> bound_distribution(-50, 50);
+
+  const integer_typet type;
+
+  variables.clear();
+  for(std::size_t i=0; i<number_of_variables; i++)
+    variables.push_back(symbol_exprt("x"+std::to_string(i), type));
+
+  std::vector<exprt> result;
+
+  for(std::size_t r=0; r<number_of_rows; r++)
+  {
+    exprt::operandst addends;
+    for(std::size_t a=0; a<3; a++)
+    {
+      const exprt &x=variables[variable_distribution(generator)];
+      if(generator()%2)
+        addends.push_back(x);
+      else
+        addends.push_back(unary_minus_exprt(x));
+    }
+
+    result.push_back(binary_predicate_exprt(
+      plus_exprt(addends, type),
+      ID_le,
+      from_integer(bound_distribution(generator), type)));
+  }
+
+  return result;
+}
+
+static void fourier_motzkin_benchmarks(benchmarkst &dest)
+{
+  const std::vector<std::pair<std::size_t, std::size_t>> systems=
+    { { 3, 8 }, { 4, 12 }, { 5, 16 }, { 6, 20 } };
+
+  for(const auto &s : systems)
+  {
+    std::vector<exprt> variables;
+    const auto inequalities=fm_row_system(s.first, s.second, variables);
+
+    dest.push_back(
+    {
+      "fourier_motzkin/vars:"+std::to_string(s.first)+
+        "/rows:"+std::to_string(s.second),
+      [inequalities, variables](std::size_t iterations)
+      {
+        null_message_handlert message_handler;
+
+        for(std::size_t i=0; i<iterations; i++)
+        {
+          satcheck_no_simplifiert satcheck(message_handler);
+          fm_accessort fm(bench_namespace(), satcheck, message_handler);
+          bool result=fm.eliminate_all(inequalities, variables);
+          do_not_optimize(result);
+        }
+      }
+    });
+  }
+}
+
+/// SyGuS problem with the given number of constraints, each being a chain of
+/// `depth` let bindings.
+static std::string let_heavy_sygus(std::size_t constraints, std::size_t depth)
+{
+  std::ostringstream out;
+
+  out << "(set-logic BV)\n"
+      << "(synth-fun f ((x (BitVec 32))) (BitVec 32))\n"
+      << "(declare-var x (BitVec 32))\n";
+
+  for(std::size_t c=0; c<constraints; c++)
+  {
+    out << "(constraint ";
+    for(std::size_t d=0; d<depth; d++)
+    {
+      out << "(let ((a" << d << " (BitVec 32) ";
+      if(d==0)
+        out << "(bvadd x #x" << std::hex << std::setw(8)
+            << std::setfill('0') << c << std::dec << ")";
+      else
+        out << "(bvadd a" << d-1 << " a" << d-1 << ")";
+      out << ")) ";
+    }
+    out << "(bvuge (f x) a" << depth-1 << ")";
+    for(std::size_t d=0; d<depth; d++)
+      out << ')';
+    out << ")\n";
+  }
+
+  out << "(check-synth)\n";
+  return out.str();
+}
+
+static void sygus_parser_benchmarks(benchmarkst &dest)
+{
+  const std::vector<std::pair<std::size_t, std::size_t>> sizes=
+    { { 10, 10 }, { 100, 10 }, { 10, 100 } };
+
+  for(const auto &s : sizes)
+  {
+    const std::string text=let_heavy_sygus(s.first, s.second);
+
+    dest.push_back(
+    {
+      "sygus_parser/constraints:"+std::to_string(s.first)+
+        "/let-depth:"+std::to_string(s.second),
+      [text](std::size_t iterations)
+      {
+        for(std::size_t i=0; i<iterations; i++)
+        {
+          std::istringstream in(text);
+          sygus_parsert parser(in);
+          parser.parse();
+          do_not_optimize(parser.constraints);
+        }
+      }
+    });
+  }
+
+  // throughput on inputs of the size of generated problems, read from
+  // memory as the front end does with a mapped file
+  const std::size_t depth=10;
+  const std::size_t constraint_size=let_heavy_sygus(1, depth).size();
+
+  for(const std::size_t megabytes : { 1, 8 })
+  {
+    const std::string text=
+      let_heavy_sygus((megabytes<<20)/constraint_size, depth);
+
+    dest.push_back(
+    {
+      "sygus_parser/megabytes:"+std::to_string(megabytes),
+      [text](std::size_t iterations)
+      {
+        for(std::size_t i=0; i<iterations; i++)
+        {
+          sygus_parsert parser(text.data(), text.data()+text.size());
+          parser.parse();
+          do_not_optimize(parser.constraints);
+        }
+      }
+    });
+  }
+}
+
+/// Runs the benchmark with increasing iteration counts until a run takes at
+/// least `min_time` seconds.
+/// \return nanoseconds per iteration and the number of iterations used
+static std::pair<double, std::size_t> run_benchmark(
+  const benchmarkt &benchmark,
+  double min_time)
+{
+  using clockt=std::chrono::steady_clock;
+
+  std::size_t iterations=1;
+
+  while(true)
+  {
+    const auto start=clockt::now();
+    benchmark.body(iterations);
+    const double elapsed=
+      std::chrono::duration<double>(clockt::now()-start).count();
+
+    if(elapsed>=min_time || iterations>=(std::size_t(1)<<30))
+      return { elapsed*1e9/iterations, iterations };
+
+    // aim for 1.4 times the minimum time
+    const double factor=elapsed>0 ? 1.4*min_time/elapsed : 10;
+    iterations=std::max(
+      iterations+1,
+      static_cast<std::size_t>(iterations*std::min(factor, 10.0)));
+  }
+}
+
+int main(int argc, const char *argv[])
+{
+  cmdlinet cmdline;
+  if(cmdline.parse(argc, argv, FASTSYNTH_BENCH_OPTIONS) ||
+     !cmdline.args.empty())
+  {
+    std::cerr << "Usage: fastsynth-bench [--filter substring] "
+                 "[--min-time seconds] [--repetitions n]\n";
+    return 1;
+  }
+
+  // expressions are printed in debug messages
+  register_language(new_ansi_c_language);
+  config.ansi_c.set_32();
+
+  const std::string filter=cmdline.get_value("filter");
+  const double min_time=cmdline.isset("min-time")?
+    std::stod(cmdline.get_value("min-time")):0.5;
+  const std::size_t repetitions=cmdline.isset("repetitions")?
+    std::stoul(cmdline.get_value("repetitions")):3;
+
+  benchmarkst benchmarks;
+  e_data_benchmarks(benchmarks);
+  synth_encoding_benchmarks(benchmarks);
+  verify_encoding_benchmarks(benchmarks);
+  fourier_motzkin_benchmarks(benchmarks);
+  sygus_parser_benchmarks(benchmarks);
+
+  std::cout << std::left << std::setw(48) << "Benchmark"
+            << std::right << std::setw(16) << "Time (ns)"
+            << std::setw(14) << "Iterations" << '\n'
+            << std::string(78, '-') << '\n';
+
+  for(const auto &b : benchmarks)
+  {
+    if(b.name.find(filter)==std::string::npos)
+      continue;
+
+    // report the median of the repetitions
+    std::vector<std::pair<double, std::size_t>> runs;
+    for(std::size_t r=0; r<std::max<std::size_t>(repetitions, 1); r++)
+      runs.push_back(run_benchmark(b, min_time));
+
+    std::sort(runs.begin(), runs.end());
+    const auto &median=runs[runs.size()/2];
+
+    std::cout << std::left << std::setw(48) << b.name
+              << std::right << std::setw(16) << std::fixed
+              << std::setprecision(0) << median.first
+              << std::setw(14) << median.second << '\n';
+  }
+
+  return 0;
+}
@@ -1,11 +1,16 @@
+#include <fstream>
 #include <iostream>
 
+#include <signal.h>
+
 #include <util/suffix.h>
 #include <util/cmdline.h>
 
 #include "c_frontend.h"
 #include "sygus_frontend.h"
 #include "smt2_frontend.h"
+#include "problem_frontend.h"
+#include "trace.h"
 
 #define FASTSYNTH_OPTIONS \
    "(min-program-size):" \
@@ -13,12 +18,24 @@
    "(incremental)" \
    "(simplifying-solver)" \
    "(fm)" \
+   "(fm-presolve)" \
+   "(fm-no-chernikov)" \
+   "(fm-lp-redundancy)" \
+   "(fm-threads):" \
    "(local-search)" \
+   "(local-search-jobs):" \
+   "(local-search-learners):" \
+   "(stochastic-search)" \
+   "(constant-synthesis)" \
    "(no-bitwise)" \
    "(verbosity):" \
    "(smt)" \
    "(literals)" \
+   "(cache-dir):" \
+   "(dump-problem):" \
+   "(load-problem):" \
    "(enable-division)" \
+   "(trace):" \
 
 int main(int argc, const char *argv[])
 {
@@ -29,20 +46,34 @@ int main(int argc, const char *argv[])
     return 1;
   }
 
-  if(cmdline.args.size()!=1)
+  // a loaded problem takes the place of the input file
+  if(cmdline.args.size()!=(cmdline.isset("load-problem")?0:1))
   {
     std::cerr << "Usage error\n";
     return 1;
   }
 
+  if(cmdline.isset("trace"))
+    global_tracer().enable();
+
+#ifndef _WIN32
+  // writes to a local search job that has ended fail instead of
+  // terminating us
+  signal(SIGPIPE, SIG_IGN);
+#endif
+
+  int result=0;
+
   try
   {
-    if(has_suffix(cmdline.args.back(), ".sl"))
-      return sygus_frontend(cmdline);
+    if(cmdline.isset("load-problem"))
+      result=problem_frontend(cmdline);
+    else if(has_suffix(cmdline.args.back(), ".sl"))
+      result=sygus_frontend(cmdline);
     else if(has_suffix(cmdline.args.back(), ".smt2"))
-      return smt2_frontend(cmdline);
+      result=smt2_frontend(cmdline);
     else
-      return c_frontend(cmdline);
+      result=c_frontend(cmdline);
   }
   catch(const char *s)
   {
@@ -52,4 +83,16 @@ int main(int argc, const char *argv[])
   {
     std::cerr << "Error: " << s << '\n';
   }
+
+  if(cmdline.isset("trace"))
+  {
+    std::ofstream out(cmdline.get_value("trace"));
+
+    if(!out)
+      std::cerr << "Failed to write trace file\n";
+    else
+      global_tracer().output(out);
+  }
+
+  return result;
 }
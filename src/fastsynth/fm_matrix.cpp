@@ -0,0 +1,901 @@
+#include "fm_matrix.h"
+#include "fm_simplex.h"
+
+#include <util/invariant.h>
+
+#include <algorithm>
+#include <bitset>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+const std::size_t fm_matrixt::no_wide_row=
+  std::numeric_limits<std::size_t>::max();
+
+static const std::uint64_t max_narrow=
+  std::numeric_limits<fm_matrixt::coefficientt>::max();
+
+static std::uint64_t abs64(fm_matrixt::coefficientt c)
+{
+  // INT64_MIN never occurs in a narrow row
+  return c<0 ? -c : c;
+}
+
+static std::uint64_t gcd64(std::uint64_t a, std::uint64_t b)
+{
+  while(b!=0)
+  {
+    const std::uint64_t t=a%b;
+    a=b;
+    b=t;
+  }
+  return a;
+}
+
+static mp_integer gcd_mp(mp_integer a, mp_integer b)
+{
+  if(a.is_negative())
+    a.negate();
+  if(b.is_negative())
+    b.negate();
+
+  while(!b.is_zero())
+  {
+    mp_integer t=a%b;
+    a=b;
+    b=t;
+  }
+  return a;
+}
+
+static mp_integer to_mp(fm_matrixt::coefficientt c)
+{
+  return mp_integer(static_cast<long long>(c));
+}
+
+/// Rounds towards minus infinity.
+static fm_matrixt::coefficientt floor_div(
+  fm_matrixt::coefficientt a,
+  fm_matrixt::coefficientt b)
+{
+  fm_matrixt::coefficientt q=a/b;
+  if(a%b!=0 && a<0)
+    q--;
+  return q;
+}
+
+static mp_integer floor_div(const mp_integer &a, const mp_integer &b)
+{
+  mp_integer q=a/b;
+  if(!(a%b).is_zero() && a.is_negative())
+    q-=1;
+  return q;
+}
+
+/// \return true if x*y+z*w cannot exceed the narrow range, given that all
+///   arguments are non-negative
+static bool fits(
+  std::uint64_t x,
+  std::uint64_t y,
+  std::uint64_t z,
+  std::uint64_t w)
+{
+  if(y!=0 && x>max_narrow/y)
+    return false;
+  if(w!=0 && z>max_narrow/w)
+    return false;
+  return x*y<=max_narrow-z*w;
+}
+
+static std::size_t count_bits(std::uint64_t word)
+{
+  return std::bitset<64>(word).count();
+}
+
+fm_elimination_statisticst &fm_elimination_statisticst::operator+=(
+  const fm_elimination_statisticst &other)
+{
+  eliminations+=other.eliminations;
+  rows+=other.rows;
+  generated+=other.generated;
+  chernikov_pruned+=other.chernikov_pruned;
+  subsumed+=other.subsumed;
+  redundant+=other.redundant;
+  return *this;
+}
+
+std::ostream &operator<<(
+  std::ostream &out,
+  const fm_elimination_statisticst &s)
+{
+  out << s.eliminations << " eliminations, "
+      << s.rows << " rows, "
+      << s.generated << " generated, "
+      << s.chernikov_pruned << " pruned by history, "
+      << s.subsumed << " subsumed, "
+      << s.redundant << " redundant";
+  return out;
+}
+
+fm_matrixt::fm_matrixt(std::size_t number_of_columns):
+  columns(number_of_columns),
+  nonnegative(number_of_columns, false),
+  history_words(0),
+  original_rows(0)
+{
+}
+
+fm_matrixt fm_matrixt::empty_copy() const
+{
+  fm_matrixt result(columns);
+  result.nonnegative=nonnegative;
+  result.history_words=history_words;
+  result.original_rows=original_rows;
+  result.original_supports=original_supports;
+  return result;
+}
+
+mp_integer fm_matrixt::coefficient(std::size_t row, std::size_t column) const
+{
+  if(row_info[row].wide==no_wide_row)
+    return to_mp(narrow[row*stride()+column]);
+  else
+    return wide_rows[row_info[row].wide][column];
+}
+
+void fm_matrixt::add_row(const sparse_rowt &a, const mp_integer &b)
+{
+  std::vector<mp_integer> row(stride(), 0);
+
+  for(const auto &c : a)
+  {
+    PRECONDITION(c.first<columns);
+    row[c.first]+=c.second;
+  }
+
+  row[columns]=b;
+
+  const std::size_t number=original_rows++;
+
+  if(number/64>=history_words)
+  {
+    // make room for one more word per row
+    std::vector<std::uint64_t> new_histories;
+    new_histories.reserve((history_words+1)*(number_of_rows()+1));
+
+    for(std::size_t r=0; r<number_of_rows(); r++)
+    {
+      const auto begin=histories.begin()+r*history_words;
+      new_histories.insert(new_histories.end(), begin, begin+history_words);
+      new_histories.push_back(0);
+    }
+
+    histories.swap(new_histories);
+    history_words++;
+  }
+
+  histories.resize(histories.size()+history_words, 0);
+  histories[histories.size()-history_words+number/64]|=
+    std::uint64_t(1)<<(number%64);
+
+  const std::size_t support_offset=original_supports.size();
+  original_supports.resize(support_offset+support_words(), 0);
+  for(std::size_t c=0; c<columns; c++)
+    if(!row[c].is_zero())
+      original_supports[support_offset+c/64]|=std::uint64_t(1)<<(c%64);
+
+  add_wide_row(std::move(row));
+}
+
+void fm_matrixt::add_wide_row(std::vector<mp_integer> row)
+{
+  // normalise: coefficients divided by their gcd, bound rounded down,
+  // which is exact for integer variables
+  mp_integer g=0;
+  for(std::size_t c=0; c<columns; c++)
+    g=gcd_mp(g, row[c]);
+
+  if(g>1)
+  {
+    for(std::size_t c=0; c<columns; c++)
+      row[c]/=g;
+    row[columns]=floor_div(row[columns], g);
+  }
+
+  bool is_narrow=true;
+  std::uint64_t max_abs=0;
+
+  for(const auto &v : row)
+  {
+    if(!v.is_long() ||
+       v.to_long()==std::numeric_limits<coefficientt>::min())
+    {
+      is_narrow=false;
+      break;
+    }
+    max_abs=std::max(max_abs, abs64(v.to_long()));
+  }
+
+  row_infot info;
+  info.max_abs=max_abs;
+  info.wide=no_wide_row;
+
+  if(is_narrow)
+  {
+    for(const auto &v : row)
+      narrow.push_back(v.to_long());
+  }
+  else
+  {
+    narrow.resize(narrow.size()+stride(), 0);
+    info.wide=wide_rows.size();
+    wide_rows.push_back(std::move(row));
+  }
+
+  row_info.push_back(info);
+}
+
+void fm_matrixt::add_row(const fm_matrixt &src, std::size_t row)
+{
+  PRECONDITION(src.columns==columns);
+  PRECONDITION(src.history_words==history_words);
+
+  const auto history_begin=src.histories.begin()+row*history_words;
+  histories.insert(
+    histories.end(), history_begin, history_begin+history_words);
+
+  const row_infot &info=src.row_info[row];
+
+  if(info.wide==no_wide_row)
+  {
+    const auto begin=src.narrow.begin()+row*stride();
+    narrow.insert(narrow.end(), begin, begin+stride());
+    row_info.push_back(info);
+  }
+  else
+  {
+    narrow.resize(narrow.size()+stride(), 0);
+    row_infot new_info=info;
+    new_info.wide=wide_rows.size();
+    wide_rows.push_back(src.wide_rows[info.wide]);
+    row_info.push_back(new_info);
+  }
+}
+
+void fm_matrixt::add_combination(
+  const fm_matrixt &src,
+  std::size_t lower,
+  std::size_t upper,
+  std::size_t column)
+{
+  PRECONDITION(src.columns==columns);
+  PRECONDITION(src.sign(lower, column)<0);
+  PRECONDITION(src.sign(upper, column)>0);
+  PRECONDITION(src.history_words==history_words);
+
+  // the history is the union of both histories
+  for(std::size_t w=0; w<history_words; w++)
+    histories.push_back(
+      src.histories[lower*history_words+w]|
+      src.histories[upper*history_words+w]);
+
+  const row_infot &l_info=src.row_info[lower];
+  const row_infot &u_info=src.row_info[upper];
+
+  if(l_info.wide==no_wide_row && u_info.wide==no_wide_row)
+  {
+    const coefficientt *l_row=src.narrow.data()+lower*stride();
+    const coefficientt *u_row=src.narrow.data()+upper*stride();
+
+    // scale both rows such that the column cancels out
+    const std::uint64_t l=abs64(l_row[column]), u=abs64(u_row[column]);
+    const std::uint64_t g=gcd64(l, u);
+    const std::uint64_t l_factor=u/g, u_factor=l/g;
+
+    if(fits(l_factor, l_info.max_abs, u_factor, u_info.max_abs))
+    {
+      const std::size_t offset=narrow.size();
+      narrow.resize(offset+stride());
+      coefficientt *new_row=narrow.data()+offset;
+
+      const coefficientt lf=l_factor, uf=u_factor;
+
+      for(std::size_t c=0; c<stride(); c++)
+        new_row[c]=lf*l_row[c]+uf*u_row[c];
+
+      std::uint64_t g_row=0;
+      for(std::size_t c=0; c<columns && g_row!=1; c++)
+        g_row=gcd64(g_row, abs64(new_row[c]));
+
+      if(g_row>1)
+      {
+        const coefficientt divisor=g_row;
+        for(std::size_t c=0; c<columns; c++)
+          new_row[c]/=divisor;
+        new_row[columns]=floor_div(new_row[columns], divisor);
+      }
+
+      row_infot info;
+      info.wide=no_wide_row;
+      info.max_abs=0;
+      for(std::size_t c=0; c<stride(); c++)
+        info.max_abs=std::max(info.max_abs, abs64(new_row[c]));
+
+      row_info.push_back(info);
+      return;
+    }
+  }
+
+  // arbitrary precision
+  const mp_integer l=-src.coefficient(lower, column);
+  const mp_integer u=src.coefficient(upper, column);
+  const mp_integer g=gcd_mp(l, u);
+  const mp_integer l_factor=u/g, u_factor=l/g;
+
+  std::vector<mp_integer> row(stride());
+  for(std::size_t c=0; c<stride(); c++)
+    row[c]=l_factor*src.coefficient(lower, c)+u_factor*src.coefficient(upper, c);
+
+  add_wide_row(std::move(row));
+}
+
+void fm_matrixt::add_sum(
+  const fm_matrixt &src,
+  const std::vector<std::pair<std::size_t, mp_integer>> &multiples)
+{
+  PRECONDITION(src.columns==columns);
+  PRECONDITION(src.history_words==history_words);
+
+  // src may be this matrix, hence compute everything before appending
+  std::vector<std::uint64_t> history(history_words, 0);
+  std::vector<mp_integer> row(stride(), 0);
+
+  for(const auto &m : multiples)
+  {
+    PRECONDITION(!m.second.is_negative());
+
+    for(std::size_t w=0; w<history_words; w++)
+      history[w]|=src.histories[m.first*history_words+w];
+
+    for(std::size_t c=0; c<stride(); c++)
+      if(src.sign(m.first, c)!=0 || c==columns)
+        row[c]+=m.second*src.coefficient(m.first, c);
+  }
+
+  histories.insert(histories.end(), history.begin(), history.end());
+  add_wide_row(std::move(row));
+}
+
+bool fm_matrixt::is_empty(std::size_t row) const
+{
+  for(std::size_t c=0; c<columns; c++)
+    if(sign(row, c)!=0)
+      return false;
+  return true;
+}
+
+bool fm_matrixt::is_inconsistent(std::size_t row) const
+{
+  // If all variables with non-zero coefficient are non-negative and have a
+  // positive coefficient, the left-hand side is at least zero.
+  for(std::size_t c=0; c<columns; c++)
+  {
+    const int s=sign(row, c);
+    if(s<0 || (s>0 && !nonnegative[c]))
+      return false;
+  }
+
+  return bound(row).is_negative();
+}
+
+std::size_t fm_matrixt::coefficient_hash(std::size_t row) const
+{
+  std::size_t hash=0;
+
+  for(std::size_t c=0; c<columns; c++)
+  {
+    std::size_t h;
+
+    if(row_info[row].wide==no_wide_row)
+      h=std::hash<coefficientt>()(narrow[row*stride()+c]);
+    else
+    {
+      // must agree with narrow rows for values in the narrow range
+      const mp_integer &v=wide_rows[row_info[row].wide][c];
+      if(v.is_long())
+        h=std::hash<coefficientt>()(v.to_long());
+      else
+        h=std::hash<std::string>()(integer2string(v));
+    }
+
+    hash=hash*31+h;
+  }
+
+  return hash;
+}
+
+bool fm_matrixt::same_coefficients(std::size_t row1, std::size_t row2) const
+{
+  if(row_info[row1].wide==no_wide_row && row_info[row2].wide==no_wide_row)
+  {
+    const coefficientt *r1=narrow.data()+row1*stride();
+    const coefficientt *r2=narrow.data()+row2*stride();
+    return std::equal(r1, r1+columns, r2);
+  }
+
+  for(std::size_t c=0; c<columns; c++)
+    if(coefficient(row1, c)!=coefficient(row2, c))
+      return false;
+
+  return true;
+}
+
+void fm_matrixt::remove_subsumed()
+{
+  const std::size_t none=std::numeric_limits<std::size_t>::max();
+
+  // rows with identical coefficients form a class, identified by its first
+  // row and found by hash; we keep the row with the smallest bound
+  std::unordered_multimap<std::size_t, std::size_t> classes;
+  std::vector<std::size_t> class_of(number_of_rows(), none);
+  std::vector<std::size_t> best(number_of_rows(), none);
+
+  for(std::size_t r=0; r<number_of_rows(); r++)
+  {
+    if(is_tautology(r))
+      continue;
+
+    const std::size_t hash=coefficient_hash(r);
+    const auto range=classes.equal_range(hash);
+
+    for(auto it=range.first; it!=range.second; it++)
+      if(same_coefficients(r, it->second))
+      {
+        class_of[r]=it->second;
+        break;
+      }
+
+    if(class_of[r]==none)
+    {
+      classes.emplace(hash, r);
+      class_of[r]=r;
+      best[r]=r;
+    }
+    else if(bound(r)<bound(best[class_of[r]]))
+      best[class_of[r]]=r;
+  }
+
+  fm_matrixt result=empty_copy();
+
+  for(std::size_t r=0; r<number_of_rows(); r++)
+    if(class_of[r]!=none && best[class_of[r]]==r)
+      result.add_row(*this, r);
+
+  std::swap(*this, result);
+}
+
+void fm_matrixt::count_bounds(
+  std::size_t column,
+  std::size_t &lower,
+  std::size_t &upper) const
+{
+  lower=upper=0;
+
+  for(std::size_t r=0; r<number_of_rows(); r++)
+  {
+    const int s=sign(r, column);
+    if(s<0)
+      lower++;
+    else if(s>0)
+      upper++;
+  }
+}
+
+std::int64_t fm_matrixt::elimination_growth(std::size_t column) const
+{
+  std::size_t lower, upper;
+  count_bounds(column, lower, upper);
+
+  return static_cast<std::int64_t>(lower*upper)-
+         static_cast<std::int64_t>(lower+upper);
+}
+
+std::vector<std::size_t> fm_matrixt::history(std::size_t row) const
+{
+  std::vector<std::size_t> result;
+
+  for(std::size_t w=0; w<history_words; w++)
+  {
+    const std::uint64_t word=histories[row*history_words+w];
+    for(std::size_t b=0; b<64; b++)
+      if(word&(std::uint64_t(1)<<b))
+        result.push_back(w*64+b);
+  }
+
+  return result;
+}
+
+void fm_matrixt::retain(const std::vector<bool> &keep)
+{
+  fm_matrixt result=empty_copy();
+
+  for(std::size_t r=0; r<number_of_rows(); r++)
+    if(keep[r])
+      result.add_row(*this, r);
+
+  std::swap(*this, result);
+}
+
+void fm_matrixt::remove_last_row()
+{
+  PRECONDITION(number_of_rows()>0);
+
+  if(row_info.back().wide!=no_wide_row)
+    wide_rows.pop_back();
+
+  row_info.pop_back();
+  narrow.resize(narrow.size()-stride());
+  histories.resize(histories.size()-history_words);
+}
+
+bool fm_matrixt::has_redundant_history(std::size_t row) const
+{
+  std::size_t history_size=0;
+  std::vector<std::uint64_t> eliminated(support_words(), 0);
+
+  for(std::size_t w=0; w<history_words; w++)
+  {
+    const std::uint64_t word=histories[row*history_words+w];
+    history_size+=count_bits(word);
+
+    for(std::size_t b=0; b<64; b++)
+      if(word&(std::uint64_t(1)<<b))
+      {
+        const std::size_t offset=(w*64+b)*support_words();
+        for(std::size_t s=0; s<support_words(); s++)
+          eliminated[s]|=original_supports[offset+s];
+      }
+  }
+
+  // the columns occurring in the history, but not in the row, have been
+  // eliminated, explicitly or implicitly
+  std::size_t number_eliminated=0;
+  for(std::size_t c=0; c<columns; c++)
+    if((eliminated[c/64]&(std::uint64_t(1)<<(c%64))) && sign(row, c)==0)
+      number_eliminated++;
+
+  return history_size>number_eliminated+1;
+}
+
+bool fm_matrixt::eliminate(
+  std::size_t column,
+  const fm_optionst &options,
+  fm_elimination_statisticst &statistics)
+{
+  PRECONDITION(column<columns);
+
+  statistics.eliminations++;
+  statistics.rows+=number_of_rows();
+
+  std::vector<std::size_t> lower_bounds, upper_bounds, unrelated;
+
+  for(std::size_t r=0; r<number_of_rows(); r++)
+  {
+    const int s=sign(r, column);
+    if(s<0)
+      lower_bounds.push_back(r);
+    else if(s>0)
+      upper_bounds.push_back(r);
+    else
+      unrelated.push_back(r);
+  }
+
+  fm_matrixt result=empty_copy();
+
+  // consider all pairs of upper and lower bounds
+  for(const auto lower : lower_bounds)
+    for(const auto upper : upper_bounds)
+    {
+      result.add_combination(*this, lower, upper, column);
+      statistics.generated++;
+
+      const std::size_t new_row=result.number_of_rows()-1;
+
+      if(result.is_inconsistent(new_row))
+      {
+        // keep the witness of the inconsistency
+        fm_matrixt witness=empty_copy();
+        witness.add_row(result, new_row);
+        std::swap(*this, witness);
+        return false;
+      }
+
+      if(options.chernikov && result.has_redundant_history(new_row))
+      {
+        result.remove_last_row();
+        statistics.chernikov_pruned++;
+      }
+    }
+
+  for(const auto r : unrelated)
+    result.add_row(*this, r);
+
+  const std::size_t before_subsumption=result.number_of_rows();
+  result.remove_subsumed();
+  statistics.subsumed+=before_subsumption-result.number_of_rows();
+
+  if(options.lp_redundancy)
+    statistics.redundant+=result.remove_redundant();
+
+  std::swap(*this, result);
+  return true;
+}
+
+std::size_t fm_matrixt::remove_redundant()
+{
+  fm_simplext simplex(*this);
+
+  // an infeasible system implies every row
+  if(!simplex.check())
+    return 0;
+
+  std::vector<bool> keep(number_of_rows(), true);
+  std::size_t removed=0;
+
+  for(std::size_t r=0; r<number_of_rows(); r++)
+  {
+    if(simplex.is_redundant(r))
+    {
+      simplex.deactivate(r);
+      keep[r]=false;
+      removed++;
+    }
+  }
+
+  if(removed!=0)
+    retain(keep);
+
+  return removed;
+}
+
+std::size_t fm_matrixt::remove_unbounded(
+  const std::vector<bool> &eligible_columns)
+{
+  PRECONDITION(eligible_columns.size()==columns);
+
+  std::vector<bool> keep(number_of_rows(), true);
+  std::size_t removed=0;
+  bool changed=true;
+
+  // removing rows may leave further columns one-sided
+  while(changed)
+  {
+    changed=false;
+
+    for(std::size_t c=0; c<columns; c++)
+    {
+      if(!eligible_columns[c])
+        continue;
+
+      bool has_lower=false, has_upper=false;
+
+      for(std::size_t r=0; r<number_of_rows(); r++)
+        if(keep[r])
+        {
+          const int s=sign(r, c);
+          has_lower|=s<0;
+          has_upper|=s>0;
+        }
+
+      // the variable can go to +infinity without upper bounds, and to
+      // -infinity without lower bounds unless it is non-negative
+      const bool unbounded=
+        !has_upper || (!has_lower && !nonnegative[c]);
+
+      if(!unbounded || (!has_lower && !has_upper))
+        continue;
+
+      for(std::size_t r=0; r<number_of_rows(); r++)
+        if(keep[r] && sign(r, c)!=0)
+        {
+          keep[r]=false;
+          removed++;
+          changed=true;
+        }
+    }
+  }
+
+  if(removed!=0)
+    retain(keep);
+
+  return removed;
+}
+
+bool fm_matrixt::propagate_bounds(std::size_t &removed)
+{
+  const std::size_t none=std::numeric_limits<std::size_t>::max();
+
+  removed=0;
+
+  // a few rounds suffice in practice, propagation need not terminate
+  for(std::size_t round=0; round<3; round++)
+  {
+    // leaves at most one bound per column and direction, the tightest
+    remove_subsumed();
+
+    // the rows -x <= -l and x <= u; rows with a single column are normalised
+    // to coefficient -1 or 1
+    std::vector<std::size_t> lower(columns, none), upper(columns, none);
+    std::vector<bool> is_bound(number_of_rows(), false);
+
+    for(std::size_t r=0; r<number_of_rows(); r++)
+    {
+      std::size_t column=none, count=0;
+
+      for(std::size_t c=0; c<columns && count<2; c++)
+        if(sign(r, c)!=0)
+        {
+          column=c;
+          count++;
+        }
+
+      if(count==1)
+      {
+        is_bound[r]=true;
+        (sign(r, column)<0 ? lower : upper)[column]=r;
+      }
+    }
+
+    for(std::size_t c=0; c<columns; c++)
+      if(lower[c]!=none && upper[c]!=none &&
+         (bound(lower[c])+bound(upper[c])).is_negative())
+      {
+        fm_matrixt witness=empty_copy();
+        witness.add_combination(*this, lower[c], upper[c], c);
+        std::swap(*this, witness);
+        return false;
+      }
+
+    const std::size_t number_of_old_rows=number_of_rows();
+    std::vector<bool> keep(number_of_old_rows, true);
+    bool changed=false;
+
+    for(std::size_t r=0; r<number_of_old_rows; r++)
+    {
+      if(is_bound[r])
+        continue;
+
+      // the smallest and largest value of a·x under the bounds, each the
+      // sum of |a_c| times the bound of the row bounding the term
+      std::size_t unbounded_min=0, unbounded_column=none;
+      bool bounded_max=true;
+      mp_integer min_activity=0, max_activity=0;
+
+      for(std::size_t c=0; c<columns; c++)
+      {
+        const int s=sign(r, c);
+        if(s==0)
+          continue;
+
+        const mp_integer a=coefficient(r, c);
+        const mp_integer abs_a=s<0 ? -a : a;
+        const std::size_t min_row=s>0 ? lower[c] : upper[c];
+        const std::size_t max_row=s>0 ? upper[c] : lower[c];
+
+        if(min_row==none)
+        {
+          unbounded_min++;
+          unbounded_column=c;
+        }
+        else
+          min_activity-=abs_a*bound(min_row);
+
+        if(max_row==none)
+          bounded_max=false;
+        else
+          max_activity+=abs_a*bound(max_row);
+      }
+
+      const mp_integer b=bound(r);
+
+      if(unbounded_min==0 && min_activity>b)
+      {
+        // the sum of the row and the bounds is 0 <= b-min_activity < 0
+        std::vector<std::pair<std::size_t, mp_integer>> multiples;
+        multiples.emplace_back(r, 1);
+
+        for(std::size_t c=0; c<columns; c++)
+        {
+          const int s=sign(r, c);
+          if(s!=0)
+            multiples.emplace_back(
+              s>0 ? lower[c] : upper[c],
+              s>0 ? coefficient(r, c) : -coefficient(r, c));
+        }
+
+        fm_matrixt witness=empty_copy();
+        witness.add_sum(*this, multiples);
+        std::swap(*this, witness);
+        return false;
+      }
+
+      if(bounded_max && max_activity<=b)
+      {
+        keep[r]=false; // holds under the bounds
+        continue;
+      }
+
+      if(unbounded_min>1)
+        continue;
+
+      // a_c x_c <= b - (the smallest value of the other terms)
+      for(std::size_t c=0; c<columns; c++)
+      {
+        const int s=sign(r, c);
+        if(s==0 || (unbounded_min==1 && c!=unbounded_column))
+          continue;
+
+        const mp_integer a=coefficient(r, c);
+        const mp_integer abs_a=s<0 ? -a : a;
+        const std::size_t min_row=s>0 ? lower[c] : upper[c];
+        const std::size_t bound_row=s>0 ? upper[c] : lower[c];
+
+        mp_integer rest=min_activity;
+        if(min_row!=none)
+          rest+=abs_a*bound(min_row);
+
+        const mp_integer new_bound=floor_div(b-rest, abs_a);
+
+        if(bound_row!=none && bound(bound_row)<=new_bound)
+          continue; // not tighter
+
+        std::vector<std::pair<std::size_t, mp_integer>> multiples;
+        multiples.emplace_back(r, 1);
+
+        for(std::size_t k=0; k<columns; k++)
+        {
+          const int s_k=sign(r, k);
+          if(k!=c && s_k!=0)
+            multiples.emplace_back(
+              s_k>0 ? lower[k] : upper[k],
+              s_k>0 ? coefficient(r, k) : -coefficient(r, k));
+        }
+
+        add_sum(*this, multiples);
+        changed=true;
+      }
+    }
+
+    keep.resize(number_of_rows(), true);
+
+    for(std::size_t r=0; r<number_of_old_rows; r++)
+      if(!keep[r])
+        removed++;
+
+    retain(keep);
+
+    if(!changed)
+      break;
+  }
+
+  remove_subsumed();
+  return true;
+}
+
+bool fm_matrixt::check_feasible()
+{
+  fm_simplext simplex(*this);
+
+  if(simplex.check())
+    return true;
+
+  fm_matrixt conflict=empty_copy();
+
+  for(const auto r : simplex.conflict())
+    conflict.add_row(*this, r);
+
+  std::swap(*this, conflict);
+  return false;
+}
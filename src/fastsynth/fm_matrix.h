@@ -0,0 +1,280 @@
+#ifndef CPROVER_FASTSYNTH_FM_MATRIX_H_
+#define CPROVER_FASTSYNTH_FM_MATRIX_H_
+
+#include <util/mp_arith.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <utility>
+#include <vector>
+
+/// Switches for Fourier-Motzkin elimination.
+struct fm_optionst
+{
+  fm_optionst():
+    presolve(false), chernikov(true), lp_redundancy(false), threads(0)
+  {
+  }
+
+  /// Before any elimination, propagate the bounds of single variables and
+  /// check feasibility over the rationals with a simplex. Off by default,
+  /// as the simplex runs for every assignment found by DPLL(FM).
+  bool presolve;
+
+  /// Drop combined rows whose history is too large to be irredundant
+  /// (Chernikov's rule with Imbert's implicitly eliminated variables).
+  bool chernikov;
+
+  /// Drop rows implied by the other rows, decided with an exact simplex
+  /// after every elimination. Exact, but expensive.
+  bool lp_redundancy;
+
+  /// Number of threads projecting the assignments found by DPLL(FM) while
+  /// the SAT solver searches for further ones; 0 to project each assignment
+  /// before searching for the next.
+  std::size_t threads;
+};
+
+/// Row counts of the elimination of one variable, summed over eliminations.
+struct fm_elimination_statisticst
+{
+  fm_elimination_statisticst():
+    eliminations(0),
+    rows(0),
+    generated(0),
+    chernikov_pruned(0),
+    subsumed(0),
+    redundant(0)
+  {
+  }
+
+  std::size_t eliminations;
+
+  /// Rows before the eliminations.
+  std::size_t rows;
+
+  /// Combinations of a lower and an upper bound.
+  std::size_t generated;
+
+  /// Pruned by the respective redundancy check.
+  std::size_t chernikov_pruned, subsumed, redundant;
+
+  fm_elimination_statisticst &operator+=(const fm_elimination_statisticst &);
+};
+
+std::ostream &operator<<(std::ostream &, const fm_elimination_statisticst &);
+
+/// A system of integer inequalities a·x <= b for Fourier-Motzkin elimination.
+/// Rows are stored contiguously as 64-bit coefficients followed by the bound;
+/// rows whose numbers exceed that range fall back to mp_integer. Each row
+/// carries its history, the set of rows added with add_row(const sparse_rowt
+/// &, const mp_integer &) that it was combined from. The matrix refers to its
+/// variables by column number only, hence it holds no ireps and may be used
+/// by other threads.
+class fm_matrixt
+{
+public:
+  using coefficientt=std::int64_t;
+
+  /// Coefficients by column number.
+  using sparse_rowt=std::map<std::size_t, mp_integer>;
+
+  explicit fm_matrixt(std::size_t number_of_columns);
+
+  std::size_t number_of_columns() const
+  {
+    return columns;
+  }
+
+  std::size_t number_of_rows() const
+  {
+    return row_info.size();
+  }
+
+  /// Declares that the variable in the given column cannot be negative.
+  void set_nonnegative(std::size_t column)
+  {
+    nonnegative[column]=true;
+  }
+
+  bool is_nonnegative(std::size_t column) const
+  {
+    return nonnegative[column];
+  }
+
+  /// Adds the row a·x <= b, normalised by the gcd of the coefficients. The
+  /// history of the row consists of the row alone; rows added this way are
+  /// numbered from zero in order.
+  void add_row(const sparse_rowt &a, const mp_integer &b);
+
+  /// Copies a row of a matrix with the same columns and original rows.
+  void add_row(const fm_matrixt &src, std::size_t row);
+
+  /// Adds a non-negative combination of rows of a matrix with the same
+  /// columns and original rows, which may be this one.
+  void add_sum(
+    const fm_matrixt &src,
+    const std::vector<std::pair<std::size_t, mp_integer>> &multiples);
+
+  /// Adds the combination of two rows of a matrix with the same columns that
+  /// eliminates the given column. The coefficient of the column must be
+  /// negative in `lower` and positive in `upper`.
+  void add_combination(
+    const fm_matrixt &src,
+    std::size_t lower,
+    std::size_t upper,
+    std::size_t column);
+
+  /// \return -1, 0 or 1
+  int sign(std::size_t row, std::size_t column) const
+  {
+    if(row_info[row].wide==no_wide_row)
+    {
+      const coefficientt c=narrow[row*stride()+column];
+      return c<0 ? -1 : c>0 ? 1 : 0;
+    }
+    else
+    {
+      const mp_integer &c=wide_rows[row_info[row].wide][column];
+      return c.is_negative() ? -1 : c.is_zero() ? 0 : 1;
+    }
+  }
+
+  mp_integer coefficient(std::size_t row, std::size_t column) const;
+
+  mp_integer bound(std::size_t row) const
+  {
+    return coefficient(row, columns);
+  }
+
+  /// \return true if all coefficients of the row are zero
+  bool is_empty(std::size_t row) const;
+
+  /// \return true if the row cannot be satisfied, taking non-negative
+  ///   columns into account
+  bool is_inconsistent(std::size_t row) const;
+
+  /// \return true if the row holds for all values of the variables
+  bool is_tautology(std::size_t row) const
+  {
+    return is_empty(row) && !bound(row).is_negative();
+  }
+
+  /// The number of rows in which the column has a negative coefficient
+  /// (lower bounds) and a positive coefficient (upper bounds).
+  void count_bounds(
+    std::size_t column,
+    std::size_t &lower,
+    std::size_t &upper) const;
+
+  /// The change in the number of rows caused by eliminating the column,
+  /// before any redundancy elimination.
+  std::int64_t elimination_growth(std::size_t column) const;
+
+  /// The numbers of the original rows the given row was combined from.
+  std::vector<std::size_t> history(std::size_t row) const;
+
+  /// Replaces the rows by their projection onto all columns but the given
+  /// one.
+  /// \param column Column to eliminate.
+  /// \param options Redundancy elimination to apply.
+  /// \param statistics Row counts to extend.
+  /// \return false if an inconsistent row was generated, in which case the
+  ///   rows are replaced by that row alone
+  bool eliminate(
+    std::size_t column,
+    const fm_optionst &options,
+    fm_elimination_statisticst &statistics);
+
+  /// Removes tautologies and, of the rows with identical coefficients, all
+  /// but one with the smallest bound.
+  void remove_subsumed();
+
+  /// Removes rows that are implied by the others, one at a time.
+  /// \return the number of rows removed
+  std::size_t remove_redundant();
+
+  /// Removes the rows that contain one of the given columns whose variable
+  /// can be chosen large enough, or small enough, to satisfy all its rows,
+  /// which does not change the consistency of the system.
+  /// \return the number of rows removed
+  std::size_t remove_unbounded(const std::vector<bool> &eligible_columns);
+
+  /// Derives tighter bounds on single variables from the rows, adding them
+  /// as rows, and removes the rows that hold under the bounds.
+  /// \param removed Set to the number of rows removed.
+  /// \return false if the bounds are found to be inconsistent, in which
+  ///   case the rows are replaced by an inconsistent one
+  bool propagate_bounds(std::size_t &removed);
+
+  /// Decides feasibility over the rationals with fm_simplext.
+  /// \return false if the rows are infeasible, in which case they are
+  ///   replaced by a subset that is infeasible
+  bool check_feasible();
+
+protected:
+  static const std::size_t no_wide_row;
+
+  std::size_t columns;
+
+  /// Row length: the coefficients followed by the bound.
+  std::size_t stride() const
+  {
+    return columns+1;
+  }
+
+  std::vector<bool> nonnegative;
+
+  struct row_infot
+  {
+    /// Largest absolute value in the narrow row, including the bound.
+    std::uint64_t max_abs;
+
+    /// Index into wide_rows, or no_wide_row.
+    std::size_t wide;
+  };
+
+  std::vector<row_infot> row_info;
+
+  /// Narrow rows, one stride each. Unused for wide rows.
+  std::vector<coefficientt> narrow;
+
+  std::vector<std::vector<mp_integer>> wide_rows;
+
+  /// Histories as bit sets over the original rows, history_words per row.
+  std::size_t history_words;
+  std::vector<std::uint64_t> histories;
+
+  /// Columns with non-zero coefficient in each original row, as bit sets of
+  /// support_words each.
+  std::size_t original_rows;
+  std::vector<std::uint64_t> original_supports;
+
+  std::size_t support_words() const
+  {
+    return (columns+63)/64;
+  }
+
+  /// Normalises and stores a row given in arbitrary precision, without
+  /// history.
+  void add_wide_row(std::vector<mp_integer> row);
+
+  void remove_last_row();
+
+  /// Removes the rows that are not marked.
+  void retain(const std::vector<bool> &keep);
+
+  /// Imbert's acceleration of Chernikov's rule: a row combined from more
+  /// than one plus the number of variables eliminated from its history,
+  /// explicitly or implicitly, is implied by other combinations.
+  bool has_redundant_history(std::size_t row) const;
+
+  /// A matrix with the same columns and original rows, but no rows.
+  fm_matrixt empty_copy() const;
+
+  std::size_t coefficient_hash(std::size_t row) const;
+  bool same_coefficients(std::size_t row1, std::size_t row2) const;
+};
+
+#endif /* CPROVER_FASTSYNTH_FM_MATRIX_H_ */
@@ -0,0 +1,121 @@
+#include "fm_projection.h"
+
+#include <algorithm>
+#include <iterator>
+
+/// Eliminates the given columns, cheapest first, and stops early once no
+/// rows are left.
+/// \return false if the rows are inconsistent
+static bool eliminate_columns(
+  fm_matrixt &rows,
+  std::vector<std::size_t> columns,
+  const fm_optionst &options,
+  std::map<std::size_t, fm_elimination_statisticst> &statistics,
+  const fm_observert &observer)
+{
+  while(!columns.empty() && rows.number_of_rows()!=0)
+  {
+    // columns that do not occur need no elimination
+    columns.erase(
+      std::remove_if(
+        columns.begin(),
+        columns.end(),
+        [&rows](std::size_t c)
+        {
+          std::size_t lower, upper;
+          rows.count_bounds(c, lower, upper);
+          return lower==0 && upper==0;
+        }),
+      columns.end());
+
+    if(columns.empty())
+      break;
+
+    // smallest growth first, ties broken by the given order
+    auto best=columns.begin();
+    std::int64_t best_growth=rows.elimination_growth(*best);
+
+    for(auto it=std::next(columns.begin()); it!=columns.end(); it++)
+    {
+      const std::int64_t growth=rows.elimination_growth(*it);
+
+      if(growth<best_growth)
+      {
+        best=it;
+        best_growth=growth;
+      }
+    }
+
+    const std::size_t column=*best;
+    columns.erase(best);
+
+    if(observer)
+      observer(column, rows);
+
+    if(!rows.eliminate(column, options, statistics[column]))
+      return false;
+  }
+
+  return true;
+}
+
+/// The union of the histories of the rows.
+static std::vector<std::size_t> get_core(const fm_matrixt &matrix)
+{
+  std::vector<std::size_t> result;
+
+  for(std::size_t r=0; r<matrix.number_of_rows(); r++)
+  {
+    const std::vector<std::size_t> history=matrix.history(r);
+    result.insert(result.end(), history.begin(), history.end());
+  }
+
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+
+  return result;
+}
+
+void fm_project(
+  fm_projectiont &p,
+  const fm_optionst &options,
+  const fm_observert &observer)
+{
+  // on inconsistency, the rows are replaced by inconsistent ones, whose
+  // histories are the conflict
+  if(options.presolve &&
+     (!p.rows.propagate_bounds(p.presolve_removed) ||
+      !p.rows.check_feasible()))
+  {
+    p.is_consistent=false;
+    p.refuted_by_presolve=true;
+    p.core=get_core(p.rows);
+    return;
+  }
+
+  p.is_consistent=eliminate_columns(
+    p.rows, p.existential_columns, options, p.statistics, observer);
+
+  if(!p.is_consistent)
+  {
+    p.core=get_core(p.rows);
+    return;
+  }
+
+  p.projection=p.rows;
+
+  // rows with a variable that is bounded on one side only can always be
+  // satisfied, hence do not matter for consistency
+  std::vector<bool> eligible(p.rows.number_of_columns(), false);
+  for(const auto c : p.remaining_columns)
+    eligible[c]=true;
+
+  p.rows.remove_unbounded(eligible);
+
+  p.is_consistent=eliminate_columns(
+    p.rows, p.remaining_columns, options, p.statistics, observer);
+
+  // any assignment that agrees on the rows the projection was computed
+  // from has a stronger projection
+  p.core=get_core(p.is_consistent ? p.projection : p.rows);
+}
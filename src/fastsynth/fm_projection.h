@@ -0,0 +1,79 @@
+#ifndef CPROVER_FASTSYNTH_FM_PROJECTION_H_
+#define CPROVER_FASTSYNTH_FM_PROJECTION_H_
+
+#include "fm_matrix.h"
+
+#include <functional>
+#include <map>
+#include <vector>
+
+/// A system of inequalities together with the columns to project out, and
+/// the outcome of fm_project. Holds no ireps, hence can be projected by any
+/// thread.
+struct fm_projectiont
+{
+  fm_projectiont():
+    id(0),
+    rows(0),
+    is_consistent(true),
+    refuted_by_presolve(false),
+    presolve_removed(0),
+    projection(0)
+  {
+  }
+
+  explicit fm_projectiont(fm_matrixt _rows):
+    id(0),
+    rows(std::move(_rows)),
+    is_consistent(true),
+    refuted_by_presolve(false),
+    presolve_removed(0),
+    projection(0)
+  {
+  }
+
+  /// Identifies the projection for the caller.
+  std::size_t id;
+
+  /// The system to project; the remaining rows afterwards.
+  fm_matrixt rows;
+
+  /// The columns to project out, in order of preference among equally
+  /// expensive ones.
+  std::vector<std::size_t> existential_columns;
+
+  /// The other variables, which are eliminated to check consistency only.
+  std::vector<std::size_t> remaining_columns;
+
+  bool is_consistent;
+
+  /// Whether presolving found the rows inconsistent.
+  bool refuted_by_presolve;
+
+  /// Rows removed by presolving.
+  std::size_t presolve_removed;
+
+  /// The rows without the existential columns, if consistent.
+  fm_matrixt projection;
+
+  /// The original rows the projection was computed from, or the original
+  /// rows that are inconsistent together.
+  std::vector<std::size_t> core;
+
+  /// Row counts by eliminated column.
+  std::map<std::size_t, fm_elimination_statisticst> statistics;
+};
+
+/// Called with each column before it is eliminated, and the current rows.
+using fm_observert=std::function<void(std::size_t, const fm_matrixt &)>;
+
+/// Optionally presolves the rows, then eliminates the existential columns,
+/// and then the remaining ones to check the consistency of the system.
+/// Columns are eliminated cheapest first: the one that adds the fewest rows,
+/// #lower * #upper - #lower - #upper, is next.
+void fm_project(
+  fm_projectiont &,
+  const fm_optionst &,
+  const fm_observert &observer=nullptr);
+
+#endif /* CPROVER_FASTSYNTH_FM_PROJECTION_H_ */
@@ -0,0 +1,217 @@
+#include "fm_simplex.h"
+#include "fm_matrix.h"
+
+#include <util/invariant.h>
+
+#include <limits>
+
+fm_simplext::fm_simplext(const fm_matrixt &matrix):
+  number_of_columns(matrix.number_of_columns()),
+  number_of_rows(matrix.number_of_rows()),
+  values(number_of_variables()),
+  lower(number_of_variables()),
+  upper(number_of_variables()),
+  tableau(number_of_variables())
+{
+  for(std::size_t c=0; c<number_of_columns; c++)
+    if(matrix.is_nonnegative(c))
+      lower[c].is_set=true; // zero
+
+  // initially, the slack variables are basic and everything is zero
+  for(std::size_t r=0; r<number_of_rows; r++)
+  {
+    const std::size_t s=number_of_columns+r;
+    std::vector<rationalt> &row=tableau[s];
+    row.resize(number_of_variables());
+
+    for(std::size_t c=0; c<number_of_columns; c++)
+      if(matrix.sign(r, c)!=0)
+        row[c]=rationalt(matrix.coefficient(r, c));
+
+    row_bounds.push_back(rationalt(matrix.bound(r)));
+    upper[s].is_set=true;
+    upper[s].value=row_bounds.back();
+  }
+}
+
+bool fm_simplext::can_increase(std::size_t v) const
+{
+  return !upper[v].is_set || values[v]<upper[v].value;
+}
+
+bool fm_simplext::can_decrease(std::size_t v) const
+{
+  return !lower[v].is_set || values[v]>lower[v].value;
+}
+
+void fm_simplext::update(std::size_t v, const rationalt &value)
+{
+  PRECONDITION(!is_basic(v));
+
+  const rationalt delta=value-values[v];
+
+  for(std::size_t b=0; b<number_of_variables(); b++)
+    if(is_basic(b) && !tableau[b][v].is_zero())
+      values[b]+=tableau[b][v]*delta;
+
+  values[v]=value;
+}
+
+void fm_simplext::bounds_changed(std::size_t v)
+{
+  // non-basic variables must respect their bounds
+  if(is_basic(v))
+    return;
+
+  if(lower[v].is_set && values[v]<lower[v].value)
+    update(v, lower[v].value);
+  else if(upper[v].is_set && values[v]>upper[v].value)
+    update(v, upper[v].value);
+}
+
+void fm_simplext::pivot_and_update(
+  std::size_t leaving,
+  std::size_t entering,
+  const rationalt &target)
+{
+  std::vector<rationalt> leaving_row;
+  leaving_row.swap(tableau[leaving]);
+
+  const rationalt a=leaving_row[entering];
+  const rationalt theta=(target-values[leaving])/a;
+
+  // update the assignment
+  values[leaving]=target;
+  values[entering]+=theta;
+
+  for(std::size_t b=0; b<number_of_variables(); b++)
+    if(is_basic(b) && !tableau[b][entering].is_zero())
+      values[b]+=tableau[b][entering]*theta;
+
+  // leaving = a*entering + rest  <=>  entering = (leaving - rest)/a
+  std::vector<rationalt> entering_row(number_of_variables());
+
+  for(std::size_t v=0; v<number_of_variables(); v++)
+    if(v!=entering && !leaving_row[v].is_zero())
+      entering_row[v]=(rationalt(0)-leaving_row[v])/a;
+
+  entering_row[leaving]=rationalt(1)/a;
+
+  // substitute in the other rows
+  for(std::size_t b=0; b<number_of_variables(); b++)
+  {
+    if(!is_basic(b))
+      continue;
+
+    const rationalt c=tableau[b][entering];
+    if(c.is_zero())
+      continue;
+
+    std::vector<rationalt> &row=tableau[b];
+    row[entering]=rationalt(0);
+
+    for(std::size_t v=0; v<number_of_variables(); v++)
+      if(!entering_row[v].is_zero())
+        row[v]+=c*entering_row[v];
+  }
+
+  tableau[entering].swap(entering_row);
+}
+
+void fm_simplext::set_conflict(std::size_t basic)
+{
+  conflict_rows.clear();
+
+  if(basic>=number_of_columns)
+    conflict_rows.push_back(basic-number_of_columns);
+
+  // the non-basic variables in the row are stuck at their bounds
+  for(std::size_t v=number_of_columns; v<number_of_variables(); v++)
+    if(!is_basic(v) && !tableau[basic][v].is_zero())
+      conflict_rows.push_back(v-number_of_columns);
+}
+
+bool fm_simplext::check()
+{
+  const std::size_t none=std::numeric_limits<std::size_t>::max();
+
+  conflict_rows.clear();
+
+  while(true)
+  {
+    // Bland's rule: smallest violating basic variable, smallest suitable
+    // non-basic variable; this guarantees termination
+    std::size_t leaving=none;
+    bool increase=false;
+
+    for(std::size_t v=0; v<number_of_variables() && leaving==none; v++)
+    {
+      if(!is_basic(v))
+        continue;
+
+      if(lower[v].is_set && values[v]<lower[v].value)
+      {
+        leaving=v;
+        increase=true;
+      }
+      else if(upper[v].is_set && values[v]>upper[v].value)
+        leaving=v;
+    }
+
+    if(leaving==none)
+      return true;
+
+    const std::vector<rationalt> &row=tableau[leaving];
+    std::size_t entering=none;
+
+    for(std::size_t v=0; v<number_of_variables() && entering==none; v++)
+    {
+      if(is_basic(v) || row[v].is_zero())
+        continue;
+
+      const bool positive=!row[v].is_negative();
+
+      if(increase==positive ? can_increase(v) : can_decrease(v))
+        entering=v;
+    }
+
+    if(entering==none)
+    {
+      set_conflict(leaving);
+      return false;
+    }
+
+    const rationalt target=
+      increase ? lower[leaving].value : upper[leaving].value;
+
+    pivot_and_update(leaving, entering, target);
+  }
+}
+
+bool fm_simplext::is_redundant(std::size_t row)
+{
+  PRECONDITION(row<number_of_rows);
+
+  const std::size_t s=number_of_columns+row;
+  PRECONDITION(upper[s].is_set);
+
+  // the coefficients are integers, hence a·x > b <=> a·x >= b+1
+  upper[s].is_set=false;
+  lower[s].is_set=true;
+  lower[s].value=row_bounds[row]+rationalt(1);
+  bounds_changed(s);
+
+  const bool feasible=check();
+
+  lower[s].is_set=false;
+  upper[s].is_set=true;
+  bounds_changed(s);
+
+  return !feasible;
+}
+
+void fm_simplext::deactivate(std::size_t row)
+{
+  PRECONDITION(row<number_of_rows);
+  upper[number_of_columns+row].is_set=false;
+}
@@ -0,0 +1,94 @@
+#ifndef CPROVER_FASTSYNTH_FM_SIMPLEX_H_
+#define CPROVER_FASTSYNTH_FM_SIMPLEX_H_
+
+#include <util/rational.h>
+
+#include <vector>
+
+class fm_matrixt;
+
+/// Exact rational simplex deciding feasibility of the rows a·x <= b of an
+/// fm_matrixt over the rationals, following the general simplex of Dutertre
+/// and de Moura: every row gets a slack variable s = a·x bounded by the
+/// row's bound, the variables x are unbounded unless non-negative. Bounds can
+/// be changed between checks, which keep the current tableau.
+class fm_simplext
+{
+public:
+  explicit fm_simplext(const fm_matrixt &);
+
+  /// \return true if the active rows are feasible
+  bool check();
+
+  /// The rows whose bounds are infeasible together, after check() returned
+  /// false.
+  const std::vector<std::size_t> &conflict() const
+  {
+    return conflict_rows;
+  }
+
+  /// Decides whether the row is implied by the other active rows over the
+  /// integers, i.e., whether these are infeasible with a·x >= b+1. The
+  /// active rows must be feasible.
+  bool is_redundant(std::size_t row);
+
+  /// Drops the row from the system.
+  void deactivate(std::size_t row);
+
+protected:
+  struct boundt
+  {
+    boundt():is_set(false)
+    {
+    }
+
+    bool is_set;
+    rationalt value;
+  };
+
+  std::size_t number_of_columns, number_of_rows;
+
+  /// Variables 0..columns-1 are the original ones, followed by one slack
+  /// variable per row.
+  std::size_t number_of_variables() const
+  {
+    return number_of_columns+number_of_rows;
+  }
+
+  std::vector<rationalt> values;
+  std::vector<boundt> lower, upper;
+  std::vector<rationalt> row_bounds;
+
+  /// Tableau row of each basic variable, as coefficients over all variables,
+  /// or empty for non-basic variables.
+  std::vector<std::vector<rationalt>> tableau;
+
+  bool is_basic(std::size_t v) const
+  {
+    return !tableau[v].empty();
+  }
+
+  /// \return true if the non-basic variable can be moved in the given
+  ///   direction
+  bool can_increase(std::size_t v) const;
+  bool can_decrease(std::size_t v) const;
+
+  /// Sets a non-basic variable, updating the basic ones.
+  void update(std::size_t v, const rationalt &value);
+
+  /// Moves a non-basic variable back into its bounds.
+  void bounds_changed(std::size_t v);
+
+  /// Makes the non-basic `entering` basic in place of the basic `leaving`,
+  /// which is set to `target`.
+  void pivot_and_update(
+    std::size_t leaving,
+    std::size_t entering,
+    const rationalt &target);
+
+  void set_conflict(std::size_t basic);
+
+  std::vector<std::size_t> conflict_rows;
+};
+
+#endif /* CPROVER_FASTSYNTH_FM_SIMPLEX_H_ */
@@ -3,8 +3,7 @@
 #include "fourier_motzkin.h"
 
 #include "solver.h"
-
-#include <solvers/sat/satcheck.h>
+#include "trace.h"
 
 #include <langapi/language_util.h>
 
@@ -27,8 +26,60 @@ std::set<symbol_exprt> get_symbols(const exprt &src)
   return result;
 }
 
+exprt fm_verifyt::project(const solutiont::functionst &s_functions)
+{
+  projection_clock++;
+
+  const auto cache_it=projection_cache.find(s_functions);
+
+  if(cache_it!=projection_cache.end())
+  {
+    cache_it->second.last_used=projection_clock;
+    status() << "FM RESULT (cached): "
+             << from_expr(ns, "", cache_it->second.result) << eom;
+    return cache_it->second.result;
+  }
+
+  const std::unique_ptr<propt> fm_satcheck=
+    new_satcheck_no_simplifier(get_message_handler());
+  fourier_motzkint fm_solver(ns, *fm_satcheck, get_message_handler());
+  fm_solver.existential_variables=problem.free_variables;
+  fm_solver.options=fm_options;
+
+  verify_encodingt fm_encoding;
+  fm_encoding.functions=s_functions;
+  fm_encoding.free_variables=problem.free_variables;
+
+  add_problem(fm_encoding, fm_solver);
+
+  {
+    trace_scopet trace_scope("FM", "verification");
+    solve(fm_solver, fm_satcheck.get(), solver_statistics);
+  }
+
+  exprt r=fm_solver.get_result();
+  status() << "FM RESULT: " << from_expr(ns, "", r) << eom;
+
+  if(max_cached_projections!=0 &&
+     projection_cache.size()>=max_cached_projections)
+  {
+    auto coldest=projection_cache.begin();
+    for(auto it=projection_cache.begin(); it!=projection_cache.end(); it++)
+      if(it->second.last_used<coldest->second.last_used)
+        coldest=it;
+    projection_cache.erase(coldest);
+  }
+
+  cached_projectiont &cached=projection_cache[s_functions];
+  cached.result=r;
+  cached.last_used=projection_clock;
+  return r;
+}
+
 decision_proceduret::resultt fm_verifyt::operator()(solutiont &solution)
 {
+  solver_statistics.clear();
+
   solvert solver_container(use_smt, logic, ns, get_message_handler());
   auto &solver=solver_container.get();
 
@@ -38,7 +89,12 @@ decision_proceduret::resultt fm_verifyt::operator()(solutiont &solution)
 
   add_problem(verify_encoding, solver);
 
-  auto result=solver();
+  decision_proceduret::resultt result;
+
+  {
+    trace_scopet trace_scope("SAT solving", "verification");
+    result=solve(solver, solver_container.get_prop(), solver_statistics);
+  }
 
   if(result==decision_proceduret::resultt::D_SATISFIABLE)
   {
@@ -55,31 +111,24 @@ decision_proceduret::resultt fm_verifyt::operator()(solutiont &solution)
     }
     #endif
 
+    // candidates without a symbolic encoding, e.g., from stochastic
+    // search, cannot be generalized
+    if(solution.s_functions.empty())
+      return result;
+
     // we might be able to generalize
     for(auto &f_it : solution.s_functions)
       f_it.second=simplify_expr(f_it.second, ns);
 
-    satcheck_no_simplifiert fm_satcheck(get_message_handler());
-    fourier_motzkint fm_solver(ns, fm_satcheck, get_message_handler());
-    fm_solver.existential_variables=problem.free_variables;
-
-    verify_encodingt fm_encoding;
-    fm_encoding.functions=solution.s_functions;
-    fm_encoding.free_variables=problem.free_variables;
-
-    add_problem(fm_encoding, fm_solver);
-
-    fm_solver();
+    exprt r=project(solution.s_functions);
 
-    exprt r=fm_solver.get_result();
-    status() << "FM RESULT: " << from_expr(ns, "", r) << eom;
-    
     // solve this a bit further
     solvert r_solver_container(use_smt, logic, ns, get_message_handler());
     auto &r_solver=r_solver_container.get();
     r_solver.set_to_false(r);
 
-    if(r_solver()==decision_proceduret::resultt::D_UNSATISFIABLE)
+    if(solve(r_solver, r_solver_container.get_prop(), solver_statistics)==
+       decision_proceduret::resultt::D_UNSATISFIABLE)
       return decision_proceduret::resultt::D_SATISFIABLE; // nope, give up
 
     // build new solution, try again
@@ -109,7 +158,8 @@ decision_proceduret::resultt fm_verifyt::operator()(solutiont &solution)
 
     add_problem(verify_encoding2, solver2);
 
-    auto result=solver2();
+    auto result=
+      solve(solver2, solver2_container.get_prop(), solver_statistics);
 
     if(result==decision_proceduret::resultt::D_UNSATISFIABLE)
     {
@@ -2,6 +2,26 @@
 #define CPROVER_FASTSYNTH_FM_VERIFY_H_
 
 #include "verify.h"
+#include "fm_matrix.h"
+
+#include <util/irep_hash.h>
+
+#include <unordered_map>
+
+/// Structural hash of the functions of a solution.
+struct functions_hasht
+{
+  std::size_t operator()(const solutiont::functionst &functions) const
+  {
+    std::size_t result=0;
+    for(const auto &f : functions)
+    {
+      result=hash_combine(result, irep_hash()(f.first));
+      result=hash_combine(result, irep_hash()(f.second));
+    }
+    return result;
+  }
+};
 
 /// verify a candidate solution with FM generalization
 class fm_verifyt:public verifyt
@@ -11,13 +31,45 @@ public:
     const namespacet &_ns,
     const problemt &_problem,
     message_handlert &_message_handler):
-    verifyt(_ns, _problem, _message_handler)
+    verifyt(_ns, _problem, _message_handler),
+    max_cached_projections(64),
+    projection_clock(0)
   {
   }
 
   /// Check a new candidate.
   /// \return \see decision_proceduret::resultt
-  decision_proceduret::resultt operator()(solutiont &);
+  decision_proceduret::resultt operator()(solutiont &) override;
+
+  /// Redundancy elimination used by the Fourier-Motzkin solver.
+  fm_optionst fm_options;
+
+  /// Maximum number of projections kept in projection_cache, of which the
+  /// least recently used one is evicted.
+  std::size_t max_cached_projections;
+
+protected:
+  struct cached_projectiont
+  {
+    exprt result;
+
+    /// When the projection was last used, see projection_clock.
+    std::size_t last_used;
+  };
+
+  /// Results of the Fourier-Motzkin projection by symbolic candidate, which
+  /// is the same for all candidates that differ in their constants only,
+  /// e.g., those of a local search.
+  std::unordered_map<
+    solutiont::functionst, cached_projectiont, functions_hasht>
+    projection_cache;
+
+  /// Counts the uses of projection_cache.
+  std::size_t projection_clock;
+
+  /// \return the constraint on the constants of the symbolic candidate
+  ///   under which it fails for some input
+  exprt project(const solutiont::functionst &s_functions);
 };
 
-#endif /* CPROVER_FASTSYNTH_VERIFY_H_ */
+#endif /* CPROVER_FASTSYNTH_FM_VERIFY_H_ */
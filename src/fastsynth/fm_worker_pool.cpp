@@ -0,0 +1,76 @@
+#include "fm_worker_pool.h"
+
+fm_worker_poolt::fm_worker_poolt(
+  std::size_t number_of_threads,
+  const fm_optionst &_options):
+  options(_options),
+  stop(false)
+{
+  for(std::size_t i=0; i<number_of_threads; i++)
+    threads.emplace_back(&fm_worker_poolt::run, this);
+}
+
+fm_worker_poolt::~fm_worker_poolt()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop=true;
+  }
+
+  queued_changed.notify_all();
+
+  for(auto &t : threads)
+    t.join();
+}
+
+void fm_worker_poolt::push(fm_projectiont projection)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.push_back(std::move(projection));
+  }
+
+  queued_changed.notify_one();
+}
+
+bool fm_worker_poolt::pop(fm_projectiont &projection, bool wait)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  if(wait)
+    finished_changed.wait(lock, [this] { return !finished.empty(); });
+  else if(finished.empty())
+    return false;
+
+  projection=std::move(finished.front());
+  finished.pop_front();
+  return true;
+}
+
+void fm_worker_poolt::run()
+{
+  while(true)
+  {
+    fm_projectiont projection;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      queued_changed.wait(lock, [this] { return stop || !queued.empty(); });
+
+      if(stop)
+        return;
+
+      projection=std::move(queued.front());
+      queued.pop_front();
+    }
+
+    fm_project(projection, options);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      finished.push_back(std::move(projection));
+    }
+
+    finished_changed.notify_one();
+  }
+}
@@ -0,0 +1,42 @@
+#ifndef CPROVER_FASTSYNTH_FM_WORKER_POOL_H_
+#define CPROVER_FASTSYNTH_FM_WORKER_POOL_H_
+
+#include "fm_projection.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Threads running fm_project on queued projections.
+class fm_worker_poolt
+{
+public:
+  fm_worker_poolt(std::size_t number_of_threads, const fm_optionst &);
+
+  /// Waits for the projections in progress, dropping the queued ones.
+  ~fm_worker_poolt();
+
+  void push(fm_projectiont);
+
+  /// Takes a finished projection.
+  /// \param wait Whether to wait for one if none is finished yet, which
+  ///   requires one to be pending.
+  /// \return false if none was taken
+  bool pop(fm_projectiont &, bool wait);
+
+protected:
+  const fm_optionst options;
+
+  std::mutex mutex;
+  std::condition_variable queued_changed, finished_changed;
+  std::deque<fm_projectiont> queued, finished;
+  bool stop;
+
+  std::vector<std::thread> threads;
+
+  void run();
+};
+
+#endif /* CPROVER_FASTSYNTH_FM_WORKER_POOL_H_ */
@@ -1,23 +1,29 @@
 #include "fourier_motzkin.h"
+#include "fm_worker_pool.h"
+#include "trace.h"
 
 #include <util/arith_tools.h>
 
 #include <langapi/language_util.h>
 
 #include <algorithm>
+#include <deque>
 
 exprt fourier_motzkint::get_result() const
 {
-  std::set<exprt> disjunct_set;
-  std::vector<exprt> unique_disjuncts;
+  return disjunction(result_disjuncts);
+}
 
-  for(const auto &d : result_disjuncts)
-  {
-    if(disjunct_set.insert(d).second)
-      unique_disjuncts.push_back(d);
-  }
+static bool has_ite(const exprt &src)
+{
+  if(src.id()==ID_if)
+    return true;
+
+  for(const auto &op : src.operands())
+    if(has_ite(op))
+      return true;
 
-  return disjunction(unique_disjuncts);
+  return false;
 }
 
 literalt fourier_motzkint::convert_rest(const exprt &expr)
@@ -27,8 +33,15 @@ literalt fourier_motzkint::convert_rest(const exprt &expr)
      expr.id()==ID_gt || expr.id()==ID_ge)
   {
     record_ite(expr);
+    get_variables(expr);
     literalt l=prop.new_variable();
     constraints.push_back(constraintt(l, expr));
+
+    constraintt &c=constraints.back();
+    c.has_ite=has_ite(expr);
+    if(!c.has_ite)
+      c.is_linear=get_linear_form(expr, c.linear_form);
+
     return l;
   }
   else if(expr.id()==ID_equal || expr.id()==ID_notequal)
@@ -80,11 +93,17 @@ void fourier_motzkint::record_ite(const exprt &src)
 }
 
 exprt fourier_motzkint::remove_ite(const exprt &src)
+{
+  bvt conditions;
+  return remove_ite(src, conditions);
+}
+
+exprt fourier_motzkint::remove_ite(const exprt &src, bvt &conditions)
 {
   exprt tmp=src;
 
   for(auto &op : tmp.operands())
-    op=remove_ite(op);
+    op=remove_ite(op, conditions);
 
   if(tmp.id()==ID_if)
   {
@@ -92,391 +111,219 @@ exprt fourier_motzkint::remove_ite(const exprt &src)
     tvt t=prop.l_get(l);
 
     if(t.is_true())
+    {
+      conditions.push_back(!l);
       return to_if_expr(tmp).true_case();
+    }
     else
+    {
+      conditions.push_back(l);
       return to_if_expr(tmp).false_case();
+    }
   }
   else
     return tmp;
 }
 
-void fourier_motzkint::rowt::negate()
-{
-  // ! (x<b) <--> (x>=b) <--> (-x<=-b)
-  is_strict=!is_strict;
-  fourier_motzkint::negate(addends);
-  bound.negate();
-}
-
-void fourier_motzkint::rowt::normalize()
+std::size_t fourier_motzkint::column_number(const exprt &term)
 {
-  std::map<exprt, mp_integer> coefficients;
-
-  for(const auto &a : addends)
-  {
-    mp_integer offset=a.negative?-1:1;
-    coefficients[a.expr]+=offset;
-  }
-
-  // remove the ones with zero coefficient
-  for(auto &a : addends)
-  {
-    if(coefficients[a.expr]==0)
-      a.expr=from_integer(0, a.expr.type());
-  }
-
-  // remove zeros
-  for(auto it=addends.begin(); it!=addends.end();)
-  {
-    if(it->expr.is_zero())
-      it=addends.erase(it);
-    else
-      it++;
-  }
-
-  // sort
-  std::sort(addends.begin(), addends.end(),
-    [](const addendt &A, const addendt &B) { return A.expr<B.expr; });
+  const auto entry=column_numbers.emplace(term, columns.size());
+  if(entry.second)
+    columns.push_back(term);
+  return entry.first->second;
 }
 
-bool fourier_motzkint::rowt::is_inconsistent() const
+bool fourier_motzkint::get_linear_form(
+  const exprt &src,
+  linear_formt &dest)
 {
-  if(addends.empty())
-  {
-    if(is_strict) // 0 < b
-      return bound<=0;
-    else // 0 <= b
-      return bound<0;
-  }
-  else if(addends.size()==1)
-  {
-    if(addends.front().expr.type().id()==ID_unsignedbv)
-    {
-      // these cannot be negative
-      mp_integer b=bound;
-      if(addends.front().negative)
-        b.negate();
-
-      if(is_strict) // 0 <= x < b
-        return b<=0;
-      else // 0 <= x <= b
-        return b<0;
-    }
-    else
-      return false;
-  }
+  if(src.operands().size()!=2)
+    return false;
 
-  return false;
-}
+  const exprt &lhs=to_binary_expr(src).op0();
+  const exprt &rhs=to_binary_expr(src).op1();
 
-void fourier_motzkint::rowt::eliminate_strict()
-{
-  if(is_strict)
+  if(src.id()==ID_lt || src.id()==ID_le)
   {
-    // integers only! X<b <=> X<=b-1
-    is_strict=false;
-    bound-=1;
+    dest.is_strict=src.id()==ID_lt;
+    return collect_addends(lhs, false, dest) &&
+           collect_addends(rhs, true, dest);
   }
-}
-
-fourier_motzkint::rowt::rowt(const exprt &src):
-  is_strict(false), failed(true)
-{
-  if(src.id()==ID_lt && src.operands().size()==2)
+  else if(src.id()==ID_gt || src.id()==ID_ge)
   {
-    is_strict=true;
-    collect_addends(src.op0(), false);
-    collect_addends(src.op1(), true);
-    failed=false;
-  }
-  else if(src.id()==ID_le && src.operands().size()==2)
-  {
-    is_strict=false;
-    collect_addends(src.op0(), false);
-    collect_addends(src.op1(), true);
-    failed=false;
-  }
-  else if(src.id()==ID_gt && src.operands().size()==2)
-  {
-    is_strict=true;
-    collect_addends(src.op0(), true);
-    collect_addends(src.op1(), false);
-    failed=false;
-  }
-  else if(src.id()==ID_ge && src.operands().size()==2)
-  {
-    is_strict=false;
-    collect_addends(src.op0(), true);
-    collect_addends(src.op1(), false);
-    failed=false;
+    dest.is_strict=src.id()==ID_gt;
+    return collect_addends(lhs, true, dest) &&
+           collect_addends(rhs, false, dest);
   }
   else
-    failed=true;
+    return false;
 }
 
-void fourier_motzkint::rowt::collect_addends(
+bool fourier_motzkint::collect_addends(
   const exprt &src,
-  bool negate)
+  bool negate,
+  linear_formt &dest)
 {
   if(src.id()==ID_plus)
   {
     for(const auto &op : src.operands())
-      collect_addends(op, negate);
+      if(!collect_addends(op, negate, dest))
+        return false;
   }
   else if(src.id()==ID_unary_minus)
   {
-    collect_addends(to_unary_minus_expr(src).op(), !negate);
+    return collect_addends(to_unary_minus_expr(src).op(), !negate, dest);
   }
   else if(src.id()==ID_constant)
   {
     auto const_int = numeric_cast<mp_integer>(to_constant_expr(src));
     if(!const_int.has_value())
-      failed=true;
-    else
-    {
-      // constants go to the right hand side of the inequality
-      if(!negate) const_int.value().negate();
-      bound+=const_int.value();
-    }
+      return false;
+
+    // constants go to the right hand side of the inequality
+    if(!negate) const_int.value().negate();
+    dest.bound+=const_int.value();
   }
   else
   {
-    addends.push_back(addendt());
-    addends.back().expr=src;
-    addends.back().negative=negate;
+    mp_integer &coefficient=dest.coefficients[column_number(src)];
+    if(negate)
+      coefficient-=1;
+    else
+      coefficient+=1;
   }
+
+  return true;
 }
 
-std::vector<fourier_motzkint::addendt>::const_iterator
-fourier_motzkint::rowt::find(const exprt &src) const
+fm_matrixt fourier_motzkint::new_matrix() const
 {
-  for(auto it=addends.begin();
-      it!=addends.end();
-      it++)
-  {
-    if(it->expr==src)
-      return it;
-  }
+  fm_matrixt matrix(columns.size());
 
-  return addends.end();
-}
+  for(std::size_t c=0; c<columns.size(); c++)
+    if(columns[c].type().id()==ID_unsignedbv)
+      matrix.set_nonnegative(c);
 
-exprt fourier_motzkint::addendt::as_expr() const
-{
-  if(negative)
-    return unary_minus_exprt(expr);
-  else
-    return expr;
+  return matrix;
 }
 
-exprt fourier_motzkint::rowt::as_expr() const
+void fourier_motzkint::add_row(
+  fm_matrixt &matrix,
+  const linear_formt &form,
+  bool negated)
 {
-  if(is_inconsistent())
-    return false_exprt();
-  else if(is_tautology())
-    return true_exprt();
-  else
+  if(!negated)
   {
-    assert(!addends.empty());
-    if(addends.size()==1)
-    {
-      if(addends.front().negative)
-      {
-        exprt lhs=addends.front().expr;
-        exprt rhs=from_integer(-bound, lhs.type());
-        return binary_predicate_exprt(lhs, is_strict?ID_gt:ID_ge, rhs);
-      }
-      else
-      {
-        exprt lhs=addends.front().expr;
-        exprt rhs=from_integer(bound, lhs.type());
-        return binary_predicate_exprt(lhs, is_strict?ID_lt:ID_le, rhs);
-      }
-    }
-    else
-    {
-      typet type = addends.front().as_expr().type();
-      exprt::operandst ops(addends.size());
-      transform(
-        begin(addends),
-        std::end(addends),
-        begin(ops),
-        std::mem_fn(&addendt::as_expr));
-      plus_exprt lhs(std::move(ops), std::move(type));
-
-      exprt rhs=from_integer(bound, lhs.type());
-      return binary_predicate_exprt(lhs, is_strict?ID_lt:ID_le, rhs);
-    }
+    // integers only! X<b <=> X<=b-1
+    matrix.add_row(form.coefficients, form.is_strict?form.bound-1:form.bound);
   }
-}
-
-std::string fourier_motzkint::as_string(const std::vector<addendt> &addends) const
-{
-  std::string result;
-
-  bool first=true;
-  for(const auto &a : addends)
+  else
   {
-    if(first)
-    {
-      first=false;
-      if(a.negative) result+='-';
-    }
-    else
-    {
-      if(a.negative)
-        result+='-';
-      else
-        result+='+';
-    }
+    // ! (x<b) <--> (x>=b) <--> (-x<=-b)
+    // ! (x<=b) <--> (x>b) <--> (-x<-b) <--> (-x<=-b-1)
+    fm_matrixt::sparse_rowt coefficients;
+    for(const auto &c : form.coefficients)
+      coefficients[c.first]=-c.second;
 
-    result+=from_expr(ns, "", a.expr);
-  }
+    mp_integer bound=-form.bound;
+    if(!form.is_strict)
+      bound-=1;
 
-  return result;
+    matrix.add_row(coefficients, bound);
+  }
 }
 
-std::string fourier_motzkint::as_string(const rowt &r) const
+/// c*x, for the absolute value c of the given coefficient
+static exprt scaled_term(const mp_integer &coefficient, const exprt &term)
 {
-  std::string result;
-
-  if(r.is_empty())
-    result+="0";
-  else
-    result+=as_string(r.addends);
-
-  result+=' ';
+  mp_integer c=coefficient;
+  if(c.is_negative())
+    c.negate();
 
-  if(r.is_strict)
-    result+='<';
+  if(c==1)
+    return term;
   else
-    result+="<=";
-
-  result+=' ';
-  result+=integer2string(r.bound);
-
-  return result;
+    return mult_exprt(from_integer(c, term.type()), term);
 }
 
-void fourier_motzkint::subsumption(std::list<rowt> &rows)
+exprt fourier_motzkint::as_expr(
+  const fm_matrixt &matrix,
+  std::size_t row) const
 {
-  // delete tautologies
-  for(auto r_it=rows.begin(); r_it!=rows.end();)
+  if(matrix.is_inconsistent(row))
+    return false_exprt();
+  else if(matrix.is_tautology(row))
+    return true_exprt();
+
+  exprt::operandst addends;
+  std::size_t single_column=0;
+  int single_sign=0;
+
+  for(std::size_t c=0; c<matrix.number_of_columns(); c++)
   {
-    if(r_it->is_tautology())
-      r_it=rows.erase(r_it);
-    else
-      r_it++;
+    const int sign=matrix.sign(row, c);
+    if(sign==0)
+      continue;
+
+    const exprt term=scaled_term(matrix.coefficient(row, c), columns[c]);
+    addends.push_back(sign<0?exprt(unary_minus_exprt(term)):term);
+    single_column=c;
+    single_sign=sign;
   }
 
-  std::map<addendst, mp_integer> smallest_bounds;
+  const mp_integer bound=matrix.bound(row);
 
-  for(const auto &r : rows)
+  if(addends.size()==1)
   {
-    auto b_it=smallest_bounds.find(r.addends);
-    if(b_it==smallest_bounds.end())
-      smallest_bounds[r.addends]=r.bound;
+    const exprt lhs=
+      scaled_term(matrix.coefficient(row, single_column), columns[single_column]);
+
+    if(single_sign<0)
+      return binary_predicate_exprt(lhs, ID_ge, from_integer(-bound, lhs.type()));
     else
-      b_it->second=std::min(b_it->second, r.bound);
+      return binary_predicate_exprt(lhs, ID_le, from_integer(bound, lhs.type()));
   }
-
-  // delete subsumed ones
-  for(auto r_it=rows.begin(); r_it!=rows.end();)
+  else
   {
-    if(smallest_bounds[r_it->addends]==r_it->bound)
-      r_it++; // strongest
-    else
-      r_it=rows.erase(r_it); // subsumed
+    typet type=addends.front().type();
+    plus_exprt lhs(std::move(addends), type);
+    return binary_predicate_exprt(lhs, ID_le, from_integer(bound, type));
   }
 }
 
-fourier_motzkint::resultt fourier_motzkint::eliminate(
-  const exprt &x,
-  std::list<rowt> &rows)
+std::string fourier_motzkint::as_string(
+  const fm_matrixt &matrix,
+  std::size_t row) const
 {
-  // collect the lower and upper bounds on 'x'
-  std::list<rowt> lower_bounds, upper_bounds, unrelated;
+  std::string result;
 
-  for(const auto &r : rows)
+  for(std::size_t c=0; c<matrix.number_of_columns(); c++)
   {
-    debug() << "FM BOUND: " << as_string(r) << eom;
-    auto it=r.find(x);
-
-    if(it==r.end())
-      unrelated.push_back(r);
-    else
-    {
-      {
-        std::vector<addendt> new_r;
+    const int sign=matrix.sign(row, c);
+    if(sign==0)
+      continue;
 
-        for(const auto &a : r.addends)
-          if(a.expr!=x)
-            new_r.push_back(a);
+    if(sign<0)
+      result+='-';
+    else if(!result.empty())
+      result+='+';
 
-        if(it->negative)
-          debug() << "FM LOWER: " << as_string(new_r)
-                  << (r.bound>0 || new_r.empty()?"":"+") << -r.bound
-                  << (r.is_strict?" < ":" <= ") << from_expr(ns, "", x) << eom;
-        else
-        {
-          negate(new_r);
-          debug() << "FM UPPER: " << from_expr(ns, "", x)
-                  << (r.is_strict?" < ":" <= ") << as_string(new_r)
-                  << (r.bound.is_negative() || new_r.empty()?"":"+") << r.bound << eom;
-        }
-      }
+    mp_integer coefficient=matrix.coefficient(row, c);
+    if(coefficient.is_negative())
+      coefficient.negate();
+    if(coefficient!=1)
+      result+=integer2string(coefficient)+'*';
 
-      if(it->negative)
-        lower_bounds.push_back(r);
-      else
-        upper_bounds.push_back(r);
-    }
+    result+=from_expr(ns, "", columns[c]);
   }
 
-  std::list<rowt> new_rows;
-
-  // now form new constraints,
-  // considering all pairs of upper and lower bounds
-  for(const auto &lower : lower_bounds)
-    for(const auto &upper: upper_bounds)
-    {
-      rowt new_row=lower;
-      for(const auto &a : upper.addends)
-        new_row.addends.push_back(a);
-      new_row.bound+=upper.bound;
-
-      new_row.normalize();
-      new_rows.push_back(new_row);
-      debug() << "FM NEW:   " << as_string(new_row) << eom;
-    }
-
-  for(const auto &r : unrelated)
-    debug() << "FM UNREL: " << as_string(r) << eom;
-
-  for(const auto &r : new_rows)
-    if(r.is_inconsistent())
-    {
-      debug() << "FM INCONSISTENT" << eom;
-      return resultt::D_UNSATISFIABLE;
-    }
-
-  for(const auto &r : unrelated)
-    new_rows.push_back(r);
-
-  if(new_rows.empty())
-    debug() << "FM CONSISTENT (TAUTOLOGY)" << eom;
-  else
-    debug() << "FM CONSISTENT" << eom;
-
-  // subsumption check
-  subsumption(new_rows);
-
-  for(const auto &r : new_rows)
-    debug() << "FM FINAL: " << as_string(r) << eom;
+  if(result.empty())
+    result+="0";
 
-  rows.swap(new_rows);
+  result+=" <= ";
+  result+=integer2string(matrix.bound(row));
 
-  return resultt::D_SATISFIABLE;
+  return result;
 }
 
 void fourier_motzkint::get_variables(const exprt &src)
@@ -491,12 +338,29 @@ void fourier_motzkint::get_variables(const exprt &src)
   }
 }
 
-void fourier_motzkint::eliminate()
+/// Collects the literals of the given rows.
+static void get_literals(
+  const std::vector<std::size_t> &rows,
+  const std::vector<bvt> &row_literals,
+  bvt &dest)
 {
-  for(const auto &c : constraints)
-    get_variables(c.expr);
+  dest.clear();
 
-  std::list<rowt> rows;
+  for(const auto r : rows)
+    dest.insert(dest.end(), row_literals[r].begin(), row_literals[r].end());
+
+  std::sort(dest.begin(), dest.end());
+  dest.erase(std::unique(dest.begin(), dest.end()), dest.end());
+}
+
+fm_projectiont fourier_motzkint::new_projection(std::vector<bvt> &row_literals)
+{
+  // linear forms of constraints with if-then-else for this assignment;
+  // a deque keeps the references stable
+  std::deque<linear_formt> ite_forms;
+  std::vector<std::pair<const linear_formt *, bool>> forms;
+
+  row_literals.clear();
 
   for(const auto &c : constraints)
   {
@@ -504,94 +368,170 @@ void fourier_motzkint::eliminate()
     if(value.is_unknown())
       continue;
 
-    exprt tmp=remove_ite(c.expr);
+    bvt literals(1, value.is_true() ? !c.l : c.l);
 
-    rowt r(tmp);
-    if(!r)
+    if(c.has_ite)
     {
-      if(value.is_false())
-        r.negate();
-
-      r.eliminate_strict();
-      r.normalize();
-
-      rows.push_back(r);
+      ite_forms.emplace_back();
+      if(get_linear_form(remove_ite(c.expr, literals), ite_forms.back()))
+      {
+        forms.emplace_back(&ite_forms.back(), value.is_false());
+        row_literals.push_back(literals);
+      }
+    }
+    else if(c.is_linear)
+    {
+      forms.emplace_back(&c.linear_form, value.is_false());
+      row_literals.push_back(literals);
     }
   }
 
-  // first do the existential ones
-  for(const auto &x : existential_variables)
-  {
-    debug() << "FM x='" << from_expr(ns, "", x) << '\'' << eom;
+  // all columns are known now
+  fm_projectiont result(new_matrix());
 
-    auto result=eliminate(x, rows);
+  for(const auto &f : forms)
+    add_row(result.rows, *f.first, f.second);
 
-    if(result==resultt::D_UNSATISFIABLE)
-      return;
+  for(const auto &x : existential_variables)
+  {
+    const auto column_it=column_numbers.find(x);
+    if(column_it!=column_numbers.end())
+      result.existential_columns.push_back(column_it->second);
   }
 
-  // remember what we have now
-  auto projection_result=rows;
-
-  // run a bit more, in case the rest is inconsistent
   for(const auto &x : variables)
   {
-    if(existential_variables.find(x)!=existential_variables.end())
-      continue; // done already
+    const auto column_it=column_numbers.find(x);
+    if(column_it!=column_numbers.end() &&
+       existential_variables.find(x)==existential_variables.end())
+      result.remaining_columns.push_back(column_it->second);
+  }
+
+  return result;
+}
+
+void fourier_motzkint::merge(
+  const fm_projectiont &projection,
+  const std::vector<bvt> &row_literals,
+  bvt &blocking_clause)
+{
+  for(const auto &s : projection.statistics)
+    elimination_statistics[s.first]+=s.second;
+
+  if(projection.refuted_by_presolve)
+    presolve_refuted++;
+  presolve_removed+=projection.presolve_removed;
 
-    debug() << "FM x='" << from_expr(ns, "", x) << '\'' << eom;
+  get_literals(projection.core, row_literals, blocking_clause);
 
-    auto result=eliminate(x, rows);
+  if(!projection.is_consistent)
+  {
+    if(is_debug())
+    {
+      debug() << "FM INCONSISTENT" << eom;
+      for(std::size_t r=0; r<projection.rows.number_of_rows(); r++)
+        debug() << "FM CONFLICT: " << as_string(projection.rows, r) << eom;
+    }
 
-    if(result==resultt::D_UNSATISFIABLE)
-      return;
+    return;
   }
 
-  debug() << "FM DONE!" << eom;
+  const fm_matrixt &rows=projection.projection;
+
+  if(is_debug())
+  {
+    if(rows.number_of_rows()==0)
+      debug() << "FM CONSISTENT (TAUTOLOGY)" << eom;
+    else
+      debug() << "FM CONSISTENT" << eom;
+
+    for(std::size_t r=0; r<rows.number_of_rows(); r++)
+      debug() << "FM FINAL: " << as_string(rows, r) << eom;
+  }
 
   exprt::operandst conjuncts;
-  for(const auto &r: projection_result)
-    conjuncts.push_back(r.as_expr());
+  for(std::size_t r=0; r<rows.number_of_rows(); r++)
+    conjuncts.push_back(as_expr(rows, r));
+
+  const exprt disjunct=conjunction(conjuncts);
 
-  result_disjuncts.push_back(conjunction(conjuncts));
+  if(disjunct_set.insert(disjunct).second)
+    result_disjuncts.push_back(disjunct);
 }
 
-void fourier_motzkint::assignment()
+bool fourier_motzkint::assignment()
 {
-  for(const auto &c : constraints)
+  if(is_debug())
   {
-    tvt value=prop.l_get(c.l);
+    for(const auto &c : constraints)
+    {
+      tvt value=prop.l_get(c.l);
 
-    exprt tmp=remove_ite(c.expr);
+      exprt tmp=remove_ite(c.expr);
 
-    debug() << "FM ";
-    debug().width(9);
-    debug() << std::left << std::string(value.to_string())+": "
-            << from_expr(ns, "", tmp) << eom;
+      debug() << "FM ";
+      debug().width(9);
+      debug() << std::left << std::string(value.to_string())+": "
+              << from_expr(ns, "", tmp) << eom;
+    }
   }
 
-  eliminate();
+  std::vector<bvt> row_literals;
+  fm_projectiont projection=new_projection(row_literals);
 
-  // block it
-  bvt blocking_clause;
+  fm_observert observer;
 
-  for(const auto &c : constraints)
+  if(is_debug())
   {
-    tvt value=prop.l_get(c.l);
-    if(value.is_unknown())
-      continue;
+    observer=[this](std::size_t column, const fm_matrixt &rows)
+    {
+      debug() << "FM x='" << from_expr(ns, "", columns[column])
+              << "' growth " << rows.elimination_growth(column) << eom;
 
-    if(value.is_true())
-      blocking_clause.push_back(!c.l);
-    else
-      blocking_clause.push_back(c.l);
+      for(std::size_t r=0; r<rows.number_of_rows(); r++)
+        debug() << "FM BOUND: " << as_string(rows, r) << eom;
+    };
   }
 
+  {
+    trace_scopet trace_scope("FM projection", "fm");
+    fm_project(projection, options, observer);
+  }
+
+  // block it
+  bvt blocking_clause;
+  merge(projection, row_literals, blocking_clause);
+
+  debug() << "FM BLOCKING " << blocking_clause.size() << " literals" << eom;
+
+  if(blocking_clause.empty())
+    return false;
+
   prop.lcnf(blocking_clause);
+  return true;
+}
+
+void fourier_motzkint::output_statistics()
+{
+  if(options.presolve)
+  {
+    statistics() << "FM presolve: " << presolve_refuted
+                 << " assignments refuted, " << presolve_removed
+                 << " rows removed" << eom;
+  }
+
+  for(const auto &s : elimination_statistics)
+  {
+    statistics() << "FM " << from_expr(ns, "", columns[s.first]) << ": "
+                 << s.second << eom;
+  }
 }
 
 decision_proceduret::resultt fourier_motzkint::dec_solve()
 {
+  if(options.threads!=0)
+    return dec_solve_parallel();
+
   unsigned iteration=0;
 
   while(true)
@@ -604,10 +544,15 @@ decision_proceduret::resultt fourier_motzkint::dec_solve()
     switch(result)
     {
     case propt::resultt::P_SATISFIABLE:
-      assignment();
+      if(!assignment())
+      {
+        output_statistics();
+        return resultt::D_UNSATISFIABLE;
+      }
       break; // next iteration
 
     case propt::resultt::P_UNSATISFIABLE:
+      output_statistics();
       return resultt::D_UNSATISFIABLE;
 
     case propt::resultt::P_ERROR:
@@ -616,3 +561,91 @@ decision_proceduret::resultt fourier_motzkint::dec_solve()
   }
 }
 
+decision_proceduret::resultt fourier_motzkint::dec_solve_parallel()
+{
+  fm_worker_poolt pool(options.threads, options);
+
+  // the row literals of the projections in progress
+  std::map<std::size_t, std::vector<bvt>> pending;
+  std::size_t next_id=0;
+
+  unsigned iteration=0;
+  bool done=false;
+
+  // a finished projection blocks the constraints relevant to it, which is
+  // stronger than blocking the whole assignment
+  auto merge_finished=[&](bool wait)
+  {
+    fm_projectiont projection;
+
+    while(!pending.empty() && pool.pop(projection, wait))
+    {
+      const auto pending_it=pending.find(projection.id);
+
+      bvt blocking_clause;
+      merge(projection, pending_it->second, blocking_clause);
+      pending.erase(pending_it);
+
+      if(blocking_clause.empty())
+        done=true;
+      else
+        prop.lcnf(blocking_clause);
+
+      wait=false;
+    }
+  };
+
+  while(!done)
+  {
+    // keep the workers busy, but not too far behind
+    merge_finished(pending.size()>=2*options.threads);
+
+    if(done)
+      break;
+
+    iteration++;
+
+    status() << "******** DPLL(FM) iteration " << iteration << eom;
+    propt::resultt result=prop.prop_solve();
+
+    switch(result)
+    {
+    case propt::resultt::P_SATISFIABLE:
+      {
+        std::vector<bvt> row_literals;
+        fm_projectiont projection=new_projection(row_literals);
+        projection.id=next_id++;
+
+        // block the whole assignment until the projection is done
+        std::vector<std::size_t> all_rows;
+        for(std::size_t r=0; r<row_literals.size(); r++)
+          all_rows.push_back(r);
+
+        bvt blocking_clause;
+        get_literals(all_rows, row_literals, blocking_clause);
+
+        pending[projection.id]=std::move(row_literals);
+        pool.push(std::move(projection));
+
+        if(blocking_clause.empty())
+          done=true;
+        else
+          prop.lcnf(blocking_clause);
+      }
+      break; // next iteration
+
+    case propt::resultt::P_UNSATISFIABLE:
+      done=true;
+      break;
+
+    case propt::resultt::P_ERROR:
+      return resultt::D_ERROR;
+    }
+  }
+
+  while(!pending.empty())
+    merge_finished(true);
+
+  output_statistics();
+  return resultt::D_UNSATISFIABLE;
+}
@@ -1,7 +1,11 @@
+#include <map>
 #include <set>
+#include <unordered_set>
 
 #include <solvers/prop/prop_conv_solver.h>
 
+#include "fm_projection.h"
+
 class fourier_motzkint : public prop_conv_solvert, messaget
 {
 public:
@@ -9,6 +13,9 @@ public:
 
   std::set<exprt> existential_variables;
 
+  /// Redundancy elimination of the matrices.
+  fm_optionst options;
+
   // result of quantification
   exprt get_result() const;
 
@@ -18,7 +25,9 @@ public:
     message_handlert &message_handler)
     : prop_conv_solvert(_prop, message_handler),
       messaget(message_handler),
-      ns(_ns)
+      ns(_ns),
+      presolve_refuted(0),
+      presolve_removed(0)
   {
   }
 
@@ -27,15 +36,37 @@ public:
     return "Fourier-Motzkin variable elimination";
   }
 
+  /// Prints the row counts of the eliminations per variable.
+  void output_statistics();
+
 protected:
   const namespacet &ns;
 
+  /// Linear form a·x < b or a·x <= b of an inequality.
+  struct linear_formt
+  {
+    linear_formt():is_strict(false)
+    {
+    }
+
+    fm_matrixt::sparse_rowt coefficients;
+    mp_integer bound;
+    bool is_strict;
+  };
+
   struct constraintt
   {
     literalt l;
     exprt expr;
+
+    /// The linear form of constraints with if-then-else depends on the
+    /// assignment, otherwise it is computed once.
+    bool has_ite;
+    bool is_linear;
+    linear_formt linear_form;
+
     constraintt(literalt _l, const exprt &_expr):
-      l(_l), expr(_expr)
+      l(_l), expr(_expr), has_ite(false), is_linear(false)
     {
     }
   };
@@ -43,69 +74,74 @@ protected:
   using constraintst=std::vector<constraintt>;
   constraintst constraints;
 
-  struct addendt
-  {
-    bool negative;
-    exprt expr;
-    void negate() { negative=!negative; }
-    addendt():negative(false) { }
-    exprt as_expr() const;
-  };
+  /// Terms of the linear forms, which are the columns of the matrices.
+  /// Terms that are not variables are never eliminated.
+  std::vector<exprt> columns;
+  std::map<exprt, std::size_t> column_numbers;
 
-  friend bool operator<(const addendt &a, const addendt &b)
-  {
-    if(a.expr<b.expr) return true;
-    if(b.expr<a.expr) return false;
-    return a.negative < b.negative;
-  }
+  std::size_t column_number(const exprt &);
 
-  using addendst=std::vector<addendt>;
+  /// Computes the linear form of an inequality.
+  /// \return false if the expression is not a linear inequality
+  bool get_linear_form(const exprt &, linear_formt &);
+  bool collect_addends(const exprt &, bool negate, linear_formt &);
 
-  static void negate(addendst &addends)
-  {
-    for(auto &a : addends)
-      a.negate();
-  }
+  /// A matrix over the current columns.
+  fm_matrixt new_matrix() const;
 
-  class rowt
-  {
-  public:
-    addendst addends;
-    bool is_strict;
-    void negate();
-    explicit rowt(const exprt &);
-    operator bool() const { return failed; }
-    mp_integer bound;
+  /// Adds the given linear form as non-strict row, which is exact for
+  /// integers.
+  /// \param negated Whether to add the negation of the inequality.
+  static void add_row(fm_matrixt &, const linear_formt &, bool negated);
 
-    std::vector<addendt>::const_iterator find(const exprt &src) const;
-    std::vector<addendt>::const_iterator end() const { return addends.end(); }
-    void eliminate_strict();
-    bool is_inconsistent() const;
-    bool is_tautology() const { return addends.empty() && !is_inconsistent(); }
-    bool is_empty() const { return addends.empty(); }
-    void normalize();
-    exprt as_expr() const;
-
-  protected:
-    bool failed;
-    void collect_addends(const exprt &, bool negate);
-  };
+  exprt as_expr(const fm_matrixt &, std::size_t row) const;
+  std::string as_string(const fm_matrixt &, std::size_t row) const;
 
-  std::string as_string(const std::vector<addendt> &) const;
-  std::string as_string(const rowt &) const;
+  bool is_debug() const
+  {
+    return message_handler &&
+           get_message_handler().get_verbosity()>=M_DEBUG;
+  }
 
   virtual literalt convert_rest(const exprt &) override;
   void record_ite(const exprt &);
   exprt remove_ite(const exprt &);
 
-  void subsumption(std::list<rowt> &);
-  void assignment();
-  void eliminate();
+  /// Replaces if-then-else by the case chosen by the current assignment.
+  /// \param conditions Extended by the literals that block the chosen cases.
+  exprt remove_ite(const exprt &, bvt &conditions);
+
+  /// Projects the current assignment and blocks it.
+  /// \return false if every assignment is blocked now
+  bool assignment();
+
+  /// DPLL(FM) with the projections running on a worker pool.
+  resultt dec_solve_parallel();
+
+  /// The rows of the current assignment.
+  /// \param row_literals Set to the literals that block the value of the
+  ///   constraint of each row and the cases of its if-then-else.
+  fm_projectiont new_projection(std::vector<bvt> &row_literals);
+
+  /// Records the result of a projection.
+  /// \param blocking_clause Set to the negation of the constraints that are
+  ///   relevant to the result: those that the projection was computed from,
+  ///   or those that are inconsistent together.
+  void merge(
+    const fm_projectiont &,
+    const std::vector<bvt> &row_literals,
+    bvt &blocking_clause);
+
+  /// Row counts of the eliminations by column, summed over all assignments.
+  std::map<std::size_t, fm_elimination_statisticst> elimination_statistics;
 
-  resultt eliminate(const exprt &x, std::list<rowt> &rows);
+  /// Assignments refuted and rows removed by presolving.
+  std::size_t presolve_refuted, presolve_removed;
 
   std::set<exprt> variables;
   void get_variables(const exprt &);
 
+  /// The projections, without duplicates.
   std::vector<exprt> result_disjuncts;
+  std::unordered_set<exprt, irep_hash> disjunct_set;
 };
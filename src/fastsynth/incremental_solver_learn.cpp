@@ -4,6 +4,9 @@
 
 #include <util/prefix.h>
 
+#include "solver.h"
+#include "trace.h"
+
 incremental_solver_learnt::incremental_solver_learnt(
   const namespacet &_ns,
   const problemt &_problem,
@@ -12,7 +15,7 @@ incremental_solver_learnt::incremental_solver_learnt(
   synth_encoding_factoryt synth_encoding_factory)
   : solver_learn_baset(
       _ns, _problem, _message_handler, std::move(synth_encoding_factory)),
-    synth_satcheck(new satcheck_no_simplifiert(_message_handler)),
+    synth_satcheck(new_satcheck_no_simplifier(_message_handler)),
     synth_solver(new bv_pointerst(ns, *synth_satcheck, _message_handler)),
     synth_encoding(this->synth_encoding_factory()),
     program_size(1u),
@@ -26,7 +29,7 @@ void incremental_solver_learnt::init()
 {
   if(use_simp_solver)
   {
-    synth_satcheck.reset(new satcheckt(get_message_handler()));
+    synth_satcheck=new_satcheck(get_message_handler());
     synth_solver.reset(
       new bv_pointerst(ns, *synth_satcheck, get_message_handler()));
   }
@@ -45,9 +48,10 @@ void incremental_solver_learnt::set_program_size(const size_t program_size)
     return;
   this->program_size = program_size;
 
-  synth_satcheck.reset(new satcheck_minisat_no_simplifiert(get_message_handler()));
+  synth_satcheck=new_satcheck_no_simplifier(get_message_handler());
   synth_solver.reset(new bv_pointerst(ns, *synth_satcheck, get_message_handler()));
   synth_encoding = synth_encoding_factory();
+  expression_counters.clear();
   synth_encoding->literals = problem.literals;
 
   init();
@@ -72,7 +76,10 @@ void incremental_solver_learnt::set_program_size(const size_t program_size)
 
 decision_proceduret::resultt incremental_solver_learnt::operator()()
 {
-  return (*synth_solver)();
+  trace_scopet trace_scope("SAT solving", "synthesis");
+  solver_statistics.clear();
+  update_expression_statistics();
+  return solve(*synth_solver, synth_satcheck.get(), solver_statistics);
 }
 
 solutiont incremental_solver_learnt::get_solution() const
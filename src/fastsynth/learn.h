@@ -2,6 +2,8 @@
 #define CPROVER_FASTSYNTH_LEARN_H_
 
 #include "cegis_types.h"
+#include "memory_statistics.h"
+#include "solver_statistics.h"
 
 #include <solvers/decision_procedure.h>
 
@@ -37,6 +39,13 @@ public:
   virtual void add_ce(const counterexamplet &) = 0;
 
   bool enable_bitwise;
+
+  /// Solver statistics of the last invocation of operator()().
+  solver_statisticst solver_statistics;
+
+  /// Sizes of the expressions passed to the solver for the last invocation
+  /// of operator()(), by kind. Only collected at statistics verbosity.
+  irep_statisticst expression_statistics;
 };
 
 #endif /* CPROVER_FASTSYNTH_LEARN_H_ */
@@ -1,14 +1,30 @@
 #include <fastsynth/local_cegis.h>
 #include <fastsynth/constant_limits.h>
+#include <fastsynth/constant_synthesis.h>
 #include <fastsynth/incremental_solver_learn.h>
 #include <fastsynth/local_synth_encoding.h>
+#include <fastsynth/problem_serialization.h>
 #include <fastsynth/solver_learn.h>
 
 #include <langapi/language_util.h>
 
 #include <util/arith_tools.h>
+#include <util/irep_serialization.h>
 
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
 #include <iterator>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 local_cegist::local_cegist(
   const namespacet &ns,
@@ -18,10 +34,21 @@ local_cegist::local_cegist(
     verify(verify),
     problem(problem),
     solution_index(0),
+    learner_clock(0),
+    total_visits(0),
+    max_local_iterations(10u),
     incremental_solving(false),
     use_simp_solver(false),
-    use_smt(true)
+    use_smt(true),
+    jobs(0),
+    use_constant_synthesis(false),
+    max_learners(0)
+{
+}
+
+local_cegist::~local_cegist()
 {
+  cancel_jobs();
 }
 
 namespace
@@ -38,13 +65,14 @@ public:
 };
 }
 
-void local_cegist::explore_neighbourhood(
+std::size_t local_cegist::explore_neighbourhood(
   const problemt &problem,
   neighbourhoodt &neighbourhood)
 {
   if(neighbourhood.is_complete)
-    return;
+    return 0;
   const solutiont &candidate = neighbourhood.solution;
+  std::size_t counterexamples = 0;
 
   debug() << "Local search on candidate: \n";
   output_expressions(candidate.functions, ns, debug());
@@ -58,11 +86,13 @@ void local_cegist::explore_neighbourhood(
     debug() << "Local search on literals...\n" << eom;
     cegist literal_cegis(ns);
     literal_cegis.set_message_handler(get_message_handler());
+    literal_cegis.memory_phase_prefix = "local search ";
     literal_cegis.incremental_solving = incremental_solving;
     literal_cegis.use_simp_solver = use_simp_solver;
     literal_cegis.use_local_search = false;
     literal_cegis.min_program_size = neighbourhood.program_size;
     literal_cegis.max_program_size = literal_cegis.min_program_size;
+    literal_cegis.record_counterexamples = true;
     current_solution = candidate;
     current_constraints.clear();
 
@@ -79,37 +109,49 @@ void local_cegist::explore_neighbourhood(
     cegis_accessort &loop = static_cast<cegis_accessort &>(literal_cegis);
     const decision_proceduret::resultt lit_result =
         loop.loop(problem, *learn, verify);
+    counterexamples += literal_cegis.counterexamples.size();
+    if(jobs != 0)
+      copy(
+        begin(literal_cegis.counterexamples),
+        end(literal_cegis.counterexamples),
+        back_inserter(shared_counterexamples));
     debug() << "Finished Local search on literals...\n" << eom;
     if(decision_proceduret::resultt::D_SATISFIABLE == lit_result)
     {
       debug() << "Local search on literals successful\n" << eom;
       solution = literal_cegis.solution;
       neighbourhood.is_complete = true;
-      return;
+      return counterexamples;
     }
   }
 
-  // Generate constraints using SMT.
-  message_handlert &msg = get_message_handler();
-  constant_limitst limits(msg, ns, problem, candidate);
-  const decision_proceduret::resultt literals_result = limits(candidate);
-  switch(literals_result)
+  // Generate constraints using SMT, unless the learner searches constants
+  // itself.
+  if(!uses_constant_synthesis())
   {
-  case decision_proceduret::resultt::D_SATISFIABLE:
-    solution = limits.solution;
-  case decision_proceduret::resultt::D_UNSATISFIABLE:
-    neighbourhood.is_complete = true;
-    return;
-  case decision_proceduret::resultt::D_ERROR:
-    copy(
-      begin(limits.result_constraints),
-      end(limits.result_constraints),
-      back_inserter(neighbourhood.constraints));
+    message_handlert &msg = get_message_handler();
+    constant_limitst limits(msg, ns, problem, candidate);
+    const decision_proceduret::resultt limits_result = limits(candidate);
+    solver_statistics += limits.solver_statistics;
+    switch(limits_result)
+    {
+    case decision_proceduret::resultt::D_SATISFIABLE:
+      solution = limits.solution;
+    case decision_proceduret::resultt::D_UNSATISFIABLE:
+      neighbourhood.is_complete = true;
+      return counterexamples;
+    case decision_proceduret::resultt::D_ERROR:
+      copy(
+        begin(limits.result_constraints),
+        end(limits.result_constraints),
+        back_inserter(neighbourhood.constraints));
+    }
   }
 
   // Run regular CEGIS loop with local_synth_encodingt
   cegist cegis(ns);
   cegis.set_message_handler(get_message_handler());
+  cegis.memory_phase_prefix = "local search ";
   cegis.incremental_solving = incremental_solving;
   cegis.use_simp_solver = use_simp_solver;
   cegis.use_smt = use_smt;
@@ -117,13 +159,24 @@ void local_cegist::explore_neighbourhood(
   cegis.use_local_search = false;
   cegis.min_program_size = neighbourhood.program_size;
   cegis.max_program_size = cegis.min_program_size;
-  cegis.max_iterations = 10u;
-  learnt &learn = *neighbourhood.learn;
+  cegis.max_iterations = max_local_iterations;
+  cegis.record_counterexamples = true;
   current_solution = candidate;
   current_constraints = neighbourhood.constraints;
+  learnt &learn = get_learner(neighbourhood);
 
   cegis_accessort &loop = static_cast<cegis_accessort &>(cegis);
   const decision_proceduret::resultt result = loop.loop(problem, learn, verify);
+  counterexamples += cegis.counterexamples.size();
+  copy(
+    begin(cegis.counterexamples),
+    end(cegis.counterexamples),
+    back_inserter(neighbourhood.counterexamples));
+  if(jobs != 0)
+    copy(
+      begin(cegis.counterexamples),
+      end(cegis.counterexamples),
+      back_inserter(shared_counterexamples));
   switch(result)
   {
   case decision_proceduret::resultt::D_SATISFIABLE:
@@ -134,12 +187,73 @@ void local_cegist::explore_neighbourhood(
   case decision_proceduret::resultt::D_ERROR:
     neighbourhood.solution = cegis.solution;
   }
+
+  return counterexamples;
+}
+
+int local_cegist::select_neighbourhood() const
+{
+  const auto is_open = [](const neighbourhoodt &n) {
+    return !n.is_complete && !n.is_running;
+  };
+
+  if(solution_index < solutions.size())
+  {
+    const neighbourhoodt &current = solutions[solution_index];
+    if(is_open(current) && current.visits == 0)
+      return static_cast<int>(solution_index);
+  }
+
+  int best = -1;
+  double best_score = 0;
+  for(size_t i = 0; i < solutions.size(); ++i)
+  {
+    const neighbourhoodt &n = solutions[i];
+    if(!is_open(n))
+      continue;
+    if(n.visits == 0)
+      return static_cast<int>(i);
+
+    const double score =
+      n.total_reward / n.visits +
+      std::sqrt(2 * std::log(static_cast<double>(total_visits)) / n.visits);
+
+    if(best == -1 || score > best_score)
+    {
+      best = static_cast<int>(i);
+      best_score = score;
+    }
+  }
+
+  return best;
 }
 
 void local_cegist::operator()()
 {
-  neighbourhoodt &neighbourhood = solutions[solution_index];
-  explore_neighbourhood(problem, neighbourhood);
+  if(jobs != 0)
+  {
+    collect_jobs();
+    int index;
+    while(running_jobs.size() < jobs && (index = select_neighbourhood()) != -1)
+      start_job(static_cast<size_t>(index));
+    return;
+  }
+
+  const int index = select_neighbourhood();
+  if(index == -1)
+    return;
+
+  neighbourhoodt &neighbourhood = solutions[static_cast<size_t>(index)];
+  const size_t constraints_before = neighbourhood.constraints.size();
+  const size_t counterexamples = explore_neighbourhood(problem, neighbourhood);
+
+  // progress is anything learned: constant ranges narrowed by constraints,
+  // or counterexamples the next candidate has to pass
+  const size_t progress = neighbourhood.constraints.size() -
+                          constraints_before + counterexamples;
+  neighbourhood.visits++;
+  neighbourhood.total_reward += 1.0 - 1.0 / (1 + progress);
+  total_visits++;
 
   debug() << "Finished limited local search on solution: \n";
   output_expressions(neighbourhood.solution.functions, ns, debug());
@@ -180,21 +294,63 @@ static void clear_constants(std::map<symbol_exprt, exprt> &solution)
     expr.second.visit(clear);
 }
 
-int local_cegist::index_of(std::map<symbol_exprt, exprt> solution)
+int local_cegist::index_of(
+  const std::map<symbol_exprt, exprt> &solution_template)
 {
-  clear_constants(solution);
-  for(size_t i=0; i < solutions.size(); ++i)
+  const auto entry = template_index.find(solution_template);
+  if(entry == template_index.end())
+    return -1;
+  return static_cast<int>(entry->second);
+}
+
+learnt &local_cegist::get_learner(neighbourhoodt &neighbourhood)
+{
+  neighbourhood.last_used = ++learner_clock;
+
+  if(!neighbourhood.learn)
   {
-    std::map<symbol_exprt, exprt> rhs(solutions[i].solution.functions);
-    clear_constants(rhs);
-    if(solution == rhs)
-      return static_cast<int>(i);
+    neighbourhood.learn = create_learner();
+    for(const auto &ce : neighbourhood.counterexamples)
+      neighbourhood.learn->add_ce(ce);
   }
-  return -1;
+
+  if(max_learners == 0)
+    return *neighbourhood.learn;
+
+  while(number_of_learners() > max_learners)
+  {
+    neighbourhoodt *coldest = nullptr;
+    for(auto &n : solutions)
+    {
+      if(n.learn && (coldest == nullptr || n.last_used < coldest->last_used))
+        coldest = &n;
+    }
+
+    debug() << "Evicting local search learner" << eom;
+    coldest->learn.reset();
+  }
+
+  return *neighbourhood.learn;
+}
+
+bool local_cegist::uses_constant_synthesis() const
+{
+  // bit-blasts the constants, hence not for integers
+  return use_constant_synthesis && logic != "LIA";
 }
 
 std::unique_ptr<learnt> local_cegist::create_learner()
 {
+  if(uses_constant_synthesis())
+  {
+    return std::unique_ptr<learnt>(new constant_synthesist(
+      ns,
+      problem,
+      current_solution,
+      current_constraints,
+      get_message_handler()));
+  }
+
   synth_encoding_factoryt synth_encoding_factory(
     local_synth_encoding(ns, current_solution, current_constraints));
   return create_learner(std::move(synth_encoding_factory));
@@ -229,7 +385,10 @@ void local_cegist::push_back(
   output_expressions(functions, ns, debug());
   debug() << eom;
 
-  int solution_index = index_of(functions);
+  std::map<symbol_exprt, exprt> cleared(functions);
+  clear_constants(cleared);
+
+  int solution_index = index_of(cleared);
   if(solution_index != -1)
   {
     this->solution_index = static_cast<size_t>(solution_index);
@@ -241,16 +400,511 @@ void local_cegist::push_back(
   debug() << eom;
 
   this->solution_index = solutions.size();
+  template_index.emplace(std::move(cleared), solutions.size());
   neighbourhoodt neighbourhood;
   neighbourhood.solution = solution_template;
   neighbourhood.program_size = program_size;
   neighbourhood.is_complete = false;
+  neighbourhood.is_running = false;
   neighbourhood.literals_search_done = false;
-  neighbourhood.learn = create_learner();
+  neighbourhood.visits = 0;
+  neighbourhood.total_reward = 0;
+  neighbourhood.last_used = 0;
   solutions.emplace_back(std::move(neighbourhood));
 }
 
 bool local_cegist::has_solution()
 {
+  if(jobs != 0 && solution.functions.empty())
+    collect_jobs();
+
   return !solution.functions.empty();
 }
+
+std::vector<counterexamplet> local_cegist::take_counterexamples()
+{
+  std::vector<counterexamplet> result;
+  result.swap(shared_counterexamples);
+  return result;
+}
+
+/// Result of a job: how the exploration ended, the solution if one was
+/// found, the updated candidate of the neighbourhood otherwise, and what
+/// was learned on the way.
+enum class job_statust
+{
+  INCOMPLETE,
+  COMPLETE,
+  SOLVED
+};
+
+/// Writes the statistics, with the solver time in microseconds.
+static void write_statistics(
+  std::ostream &out,
+  const solver_statisticst &statistics)
+{
+  irep_serializationt::write_gb_word(out, statistics.queries);
+  irep_serializationt::write_gb_word(out, statistics.variables);
+  irep_serializationt::write_gb_word(out, statistics.clauses);
+  irep_serializationt::write_gb_word(out, statistics.conflicts);
+  irep_serializationt::write_gb_word(out, statistics.decisions);
+  irep_serializationt::write_gb_word(out, statistics.propagations);
+  irep_serializationt::write_gb_word(out, statistics.restarts);
+  irep_serializationt::write_gb_word(out, statistics.memory_kb);
+  irep_serializationt::write_gb_word(
+    out, static_cast<std::size_t>(statistics.solver_time * 1e6));
+}
+
+static void read_statistics(std::istream &in, solver_statisticst &statistics)
+{
+  statistics.queries = irep_serializationt::read_gb_word(in);
+  statistics.variables = irep_serializationt::read_gb_word(in);
+  statistics.clauses = irep_serializationt::read_gb_word(in);
+  statistics.conflicts = irep_serializationt::read_gb_word(in);
+  statistics.decisions = irep_serializationt::read_gb_word(in);
+  statistics.propagations = irep_serializationt::read_gb_word(in);
+  statistics.restarts = irep_serializationt::read_gb_word(in);
+  statistics.memory_kb = irep_serializationt::read_gb_word(in);
+  statistics.solver_time = irep_serializationt::read_gb_word(in) / 1e6;
+}
+
+static void write_job_result(
+  std::ostream &out,
+  job_statust status,
+  const solutiont &solution,
+  const synth_encodingt::constraintst &constraints,
+  const std::vector<counterexamplet> &counterexamples,
+  const solver_statisticst &statistics)
+{
+  irep_serializationt::ireps_containert ireps_container;
+  irep_serializationt serializer(ireps_container);
+
+  irep_serializationt::write_gb_word(out, static_cast<std::size_t>(status));
+  write_solution(out, serializer, solution);
+
+  irep_serializationt::write_gb_word(out, constraints.size());
+  for(const exprt &c : constraints)
+    serializer.reference_convert(c, out);
+
+  irep_serializationt::write_gb_word(out, counterexamples.size());
+  for(const auto &ce : counterexamples)
+    write_counterexample(out, serializer, ce);
+
+  write_statistics(out, statistics);
+}
+
+static job_statust read_job_result(
+  std::istream &in,
+  solutiont &solution,
+  synth_encodingt::constraintst &constraints,
+  std::vector<counterexamplet> &counterexamples,
+  solver_statisticst &statistics)
+{
+  irep_serializationt::ireps_containert ireps_container;
+  irep_serializationt serializer(ireps_container);
+
+  const auto status =
+    static_cast<job_statust>(irep_serializationt::read_gb_word(in));
+  read_solution(in, serializer, solution);
+
+  const std::size_t number_of_constraints =
+    irep_serializationt::read_gb_word(in);
+  for(std::size_t i = 0; i < number_of_constraints && in; ++i)
+  {
+    irept c;
+    serializer.reference_convert(in, c);
+    constraints.push_back(static_cast<const exprt &>(c));
+  }
+
+  const std::size_t number_of_counterexamples =
+    irep_serializationt::read_gb_word(in);
+  for(std::size_t i = 0; i < number_of_counterexamples && in; ++i)
+  {
+    counterexamplet ce;
+    read_counterexample(in, serializer, ce);
+    counterexamples.push_back(std::move(ce));
+  }
+
+  read_statistics(in, statistics);
+
+  return status;
+}
+
+#ifndef _WIN32
+/// Appends the counterexample to out, preceded by its size, such that
+/// take_frames can tell whether it was received completely.
+static void frame_counterexample(const counterexamplet &ce, std::string &out)
+{
+  irep_serializationt::ireps_containert ireps_container;
+  irep_serializationt serializer(ireps_container);
+
+  std::ostringstream frame;
+  write_counterexample(frame, serializer, ce);
+  const std::string data = frame.str();
+
+  // parent and child run on the same machine
+  const std::uint64_t size = data.size();
+  out.append(reinterpret_cast<const char *>(&size), sizeof(size));
+  out += data;
+}
+
+/// Removes the complete frames from the front of input.
+static std::vector<counterexamplet> take_frames(std::string &input)
+{
+  std::vector<counterexamplet> result;
+  std::size_t offset = 0;
+
+  while(input.size() - offset >= sizeof(std::uint64_t))
+  {
+    std::uint64_t size;
+    input.copy(reinterpret_cast<char *>(&size), sizeof(size), offset);
+    if(input.size() - offset - sizeof(size) < size)
+      break;
+
+    irep_serializationt::ireps_containert ireps_container;
+    irep_serializationt serializer(ireps_container);
+    std::istringstream in(input.substr(offset + sizeof(size), size));
+    counterexamplet ce;
+    if(read_counterexample(in, serializer, ce))
+      result.push_back(std::move(ce));
+
+    offset += sizeof(size) + size;
+  }
+
+  input.erase(0, offset);
+  return result;
+}
+
+/// Writes all of data to fd.
+static void write_all(const int fd, const std::string &data)
+{
+  for(std::size_t written = 0; written < data.size();)
+  {
+    const ssize_t n =
+      write(fd, data.data() + written, data.size() - written);
+    if(n <= 0)
+      break;
+    written += n;
+  }
+}
+#endif
+
+void local_cegist::run_job(neighbourhoodt &neighbourhood, const int input)
+{
+#ifndef _WIN32
+  std::string received;
+
+  while(solution.functions.empty() && !neighbourhood.is_complete)
+  {
+    // counterexamples found by the parent and the other jobs since the
+    // last round
+    char buffer[4096];
+    ssize_t n;
+    while((n = read(input, buffer, sizeof(buffer))) > 0)
+      received.append(buffer, n);
+
+    const std::vector<counterexamplet> shared = take_frames(received);
+    if(!shared.empty())
+    {
+      learnt &learn = get_learner(neighbourhood);
+      for(const auto &ce : shared)
+      {
+        learn.add_ce(ce);
+        neighbourhood.counterexamples.push_back(ce);
+      }
+    }
+
+    const std::size_t constraints_before = neighbourhood.constraints.size();
+    const std::size_t counterexamples =
+      explore_neighbourhood(problem, neighbourhood);
+
+    // the parent may resume later, with what was learned
+    if(
+      shared.empty() && counterexamples == 0 &&
+      neighbourhood.constraints.size() == constraints_before)
+    {
+      break;
+    }
+  }
+#else
+  (void)input;
+  explore_neighbourhood(problem, neighbourhood);
+#endif
+}
+
+void local_cegist::start_job(const std::size_t index)
+{
+  neighbourhoodt &neighbourhood = solutions[index];
+
+#ifdef _WIN32
+  explore_neighbourhood(problem, neighbourhood);
+#else
+  int fds[2], to_child[2];
+  if(pipe(fds) != 0)
+  {
+    warning() << "Failed to create pipe for local search job" << eom;
+    explore_neighbourhood(problem, neighbourhood);
+    return;
+  }
+
+  if(pipe(to_child) != 0)
+  {
+    warning() << "Failed to create pipe for local search job" << eom;
+    close(fds[0]);
+    close(fds[1]);
+    explore_neighbourhood(problem, neighbourhood);
+    return;
+  }
+
+  // the child must not print what is buffered here again
+  std::cout.flush();
+  std::cerr.flush();
+
+  const pid_t pid = fork();
+
+  if(pid == -1)
+  {
+    warning() << "Failed to fork local search job" << eom;
+    close(fds[0]);
+    close(fds[1]);
+    close(to_child[0]);
+    close(to_child[1]);
+    explore_neighbourhood(problem, neighbourhood);
+    return;
+  }
+
+  if(pid == 0)
+  {
+    // child: explore, report, and exit without cleaning up the state
+    // shared with the parent
+    close(fds[0]);
+    close(to_child[1]);
+    for(const auto &job : running_jobs)
+    {
+      close(job.fd);
+      close(job.to_child);
+    }
+    running_jobs.clear();
+    shared_counterexamples.clear();
+    solver_statistics.clear();
+    fcntl(to_child[0], F_SETFL, O_NONBLOCK);
+
+    run_job(neighbourhood, to_child[0]);
+
+    job_statust status = job_statust::INCOMPLETE;
+    if(!solution.functions.empty())
+      status = job_statust::SOLVED;
+    else if(neighbourhood.is_complete)
+      status = job_statust::COMPLETE;
+
+    std::ostringstream out;
+    write_job_result(
+      out,
+      status,
+      status == job_statust::SOLVED ? solution : neighbourhood.solution,
+      neighbourhood.constraints,
+      shared_counterexamples,
+      solver_statistics);
+    write_all(fds[1], out.str());
+
+    std::cout.flush();
+    _exit(0);
+  }
+
+  close(fds[1]);
+  close(to_child[0]);
+  fcntl(to_child[1], F_SETFL, O_NONBLOCK);
+
+  debug() << "Started local search job " << pid << eom;
+
+  jobt job;
+  job.pid = pid;
+  job.fd = fds[0];
+  job.to_child = to_child[1];
+  job.neighbourhood = index;
+  running_jobs.push_back(job);
+  neighbourhood.is_running = true;
+  neighbourhood.literals_search_done = true;
+#endif
+}
+
+void local_cegist::share_counterexample(const counterexamplet &ce)
+{
+#ifndef _WIN32
+  if(running_jobs.empty())
+    return;
+
+  std::string frame;
+  frame_counterexample(ce, frame);
+  for(auto &job : running_jobs)
+    job.pending += frame;
+
+  flush_jobs();
+#else
+  (void)ce;
+#endif
+}
+
+void local_cegist::flush_jobs()
+{
+#ifndef _WIN32
+  for(auto &job : running_jobs)
+  {
+    if(job.pending.empty())
+      continue;
+
+    const ssize_t n =
+      write(job.to_child, job.pending.data(), job.pending.size());
+    if(n > 0)
+      job.pending.erase(0, n);
+    else if(n == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
+      job.pending.clear(); // the job has ended
+  }
+#endif
+}
+
+void local_cegist::collect_jobs()
+{
+#ifndef _WIN32
+  flush_jobs();
+
+  for(auto it = running_jobs.begin(); it != running_jobs.end();)
+  {
+    // a job writes its result in one go when done
+    pollfd p;
+    p.fd = it->fd;
+    p.events = POLLIN;
+    p.revents = 0;
+
+    if(poll(&p, 1, 0) <= 0)
+    {
+      ++it;
+      continue;
+    }
+
+    std::string data;
+    char buffer[4096];
+    ssize_t n;
+    while((n = read(it->fd, buffer, sizeof(buffer))) > 0)
+      data.append(buffer, n);
+
+    close(it->fd);
+    close(it->to_child);
+    waitpid(it->pid, nullptr, 0);
+
+    const jobt job = *it;
+    it = running_jobs.erase(it);
+
+    neighbourhoodt &neighbourhood = solutions[job.neighbourhood];
+    neighbourhood.is_running = false;
+    neighbourhood.visits++;
+    total_visits++;
+
+    // a failed job leaves the neighbourhood open, with no reward, hence
+    // it is retried after the more promising ones
+    if(data.empty())
+    {
+      warning() << "Local search job " << job.pid << " failed" << eom;
+      continue;
+    }
+
+    std::istringstream in(data);
+    solutiont job_solution;
+    synth_encodingt::constraintst job_constraints;
+    std::vector<counterexamplet> job_counterexamples;
+    solver_statisticst job_statistics;
+    const job_statust status = read_job_result(
+      in, job_solution, job_constraints, job_counterexamples, job_statistics);
+    solver_statistics += job_statistics;
+
+    debug() << "Local search job " << job.pid << " finished" << eom;
+
+    const std::size_t progress =
+      job_constraints.size() - neighbourhood.constraints.size() +
+      job_counterexamples.size();
+    neighbourhood.total_reward += 1.0 - 1.0 / (1 + progress);
+
+    // the other jobs learn from this one
+    for(const auto &ce : job_counterexamples)
+      share_counterexample(ce);
+
+    switch(status)
+    {
+    case job_statust::SOLVED:
+      solution = job_solution;
+      cancel_jobs();
+      copy(
+        begin(job_counterexamples),
+        end(job_counterexamples),
+        back_inserter(shared_counterexamples));
+      return;
+
+    case job_statust::COMPLETE:
+      neighbourhood.is_complete = true;
+      break;
+
+    case job_statust::INCOMPLETE:
+      // resume where the job stopped
+      if(!job_solution.functions.empty())
+        neighbourhood.solution = job_solution;
+      neighbourhood.constraints.swap(job_constraints);
+      for(const auto &ce : job_counterexamples)
+      {
+        if(neighbourhood.learn)
+          neighbourhood.learn->add_ce(ce);
+        neighbourhood.counterexamples.push_back(ce);
+      }
+      break;
+    }
+
+    copy(
+      begin(job_counterexamples),
+      end(job_counterexamples),
+      back_inserter(shared_counterexamples));
+  }
+#endif
+}
+
+void local_cegist::cancel_jobs()
+{
+#ifndef _WIN32
+  for(const auto &job : running_jobs)
+  {
+    kill(job.pid, SIGTERM);
+    close(job.fd);
+    close(job.to_child);
+    waitpid(job.pid, nullptr, 0);
+    solutions[job.neighbourhood].is_running = false;
+  }
+#endif
+
+  running_jobs.clear();
+}
+
+std::size_t local_cegist::number_of_learners() const
+{
+  std::size_t result = 0;
+  for(const auto &n : solutions)
+    if(n.learn)
+      result++;
+  return result;
+}
+
+irep_statisticst local_cegist::expression_statistics() const
+{
+  irep_countert constraints;
+  irep_statisticst result;
+
+  for(const auto &n : solutions)
+  {
+    for(const auto &c : n.constraints)
+      constraints(c);
+
+    if(n.learn)
+      for(const auto &s : n.learn->expression_statistics)
+        result["learner " + s.first] += s.second;
+  }
+
+  result["neighbourhood constraints"] = constraints.get();
+  return result;
+}
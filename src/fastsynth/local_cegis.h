@@ -2,13 +2,18 @@
 #define CPROVER_FASTSYNTH_LOCAL_CEGIS_H_
 
 #include <fastsynth/cegis.h>
+#include <fastsynth/memory_statistics.h>
+#include <fastsynth/solver_statistics.h>
 #include <fastsynth/synth_encoding.h>
 #include <fastsynth/synth_encoding_factory.h>
 
+#include <util/irep_hash.h>
 #include <util/namespace.h>
 #include <util/symbol_table.h>
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 /// SMT-based local solution neighbourhood search.
 class local_cegist : public messaget
@@ -25,19 +30,34 @@ class local_cegist : public messaget
     /// Constraints learned in local searches on this neighbourhood.
     synth_encodingt::constraintst constraints;
 
-    /// Used for restricted CEGIS learner queries on this neighbourhood.
+    /// Used for restricted CEGIS learner queries on this neighbourhood,
+    /// created when first needed, and possibly evicted, see get_learner.
     std::unique_ptr<class learnt> learn;
 
+    /// The counterexamples added to learn, to rebuild it after eviction.
+    std::vector<counterexamplet> counterexamples;
+
+    /// When learn was last used, see learner_clock.
+    std::size_t last_used;
+
     /// Indicates whether this neighbourhood was fully explored.  This is
-    /// necessary since we only complete a limited number of local CEGIS
-    /// iterations at each iteration of the overall CEGIS loop.  This
-    /// is effectively a manual scheduling algorithm, avoiding the need
-    /// to use threads.
+    /// necessary since, unless jobs are used, we only complete a limited
+    /// number of local CEGIS iterations at each iteration of the overall
+    /// CEGIS loop.  This is effectively a manual scheduling algorithm.
     bool is_complete;
 
+    /// Indicates whether a job is exploring this neighbourhood.
+    bool is_running;
+
     /// Indicates whether the search with just user-provided literals for
     /// constants is completed.
     bool literals_search_done;
+
+    /// Number of times this neighbourhood was explored by operator().
+    std::size_t visits;
+
+    /// Sum of the rewards of these explorations, each in [0, 1).
+    double total_reward;
   };
 
   /// \see cegist::cegist(const namespacet &)
@@ -56,7 +76,8 @@ class local_cegist : public messaget
   /// Explores the given template solution locally.
   /// \param problem Associated CEGIS problem.
   /// \param neighbourhood Template solution to explore.
-  void explore_neighbourhood(
+  /// \return Number of counterexamples learned.
+  std::size_t explore_neighbourhood(
     const problemt &problem,
     neighbourhoodt &neighbourhood);
 
@@ -69,11 +90,32 @@ class local_cegist : public messaget
     synth_encodingt::constraintst &constraints,
     const exprt &constraint);
 
+  /// Structural hash of a solution template.
+  struct template_hasht
+  {
+    std::size_t operator()(const std::map<symbol_exprt, exprt> &t) const
+    {
+      std::size_t result = 0;
+      for(const auto &f : t)
+      {
+        result = hash_combine(result, irep_hash()(f.first));
+        result = hash_combine(result, irep_hash()(f.second));
+      }
+      return result;
+    }
+  };
+
+  /// Index in solutions by the template of the neighbourhood, i.e., its
+  /// solution with all constants set to zero.
+  std::unordered_map<std::map<symbol_exprt, exprt>, size_t, template_hasht>
+    template_index;
+
   /// Locates the given candidate in the list of already explored or
   /// currently being explored neighbourhoods.
-  /// \param solution_template Neighbourhood to find.
+  /// \param solution_template Neighbourhood to find, with constants set to
+  ///   zero.
   /// \return Index in solutions or <code>-1</code> if not yet explored.
-  int index_of(std::map<symbol_exprt, exprt> solution_template);
+  int index_of(const std::map<symbol_exprt, exprt> &solution_template);
 
   /// Index in solutions of the currently explored solution equivalence class.
   size_t solution_index;
@@ -84,10 +126,74 @@ class local_cegist : public messaget
   /// Constraints learned on the currently explored equivalence class.
   synth_encodingt::constraintst current_constraints;
 
+  /// Incremented on each use of a learner.
+  std::size_t learner_clock;
+
+  /// Provides the learner of the given neighbourhood, rebuilding it from
+  /// its counterexamples if it was evicted, and evicts the least recently
+  /// used learners of other neighbourhoods if there are more than
+  /// max_learners.
+  learnt &get_learner(neighbourhoodt &);
+
+  /// Total number of visits of all neighbourhoods.
+  std::size_t total_visits;
+
+  /// Picks the open neighbourhood to explore next by UCB1, where the reward
+  /// of an exploration grows with the constraints and counterexamples it
+  /// learned. Unvisited neighbourhoods come first, the current one before
+  /// the others.
+  /// \return Index in solutions or <code>-1</code> if all are complete or
+  ///   running.
+  int select_neighbourhood() const;
+
+  /// Limit on the iterations of one local CEGIS run, 0 for none.
+  std::size_t max_local_iterations;
+
+  /// Counterexamples found by local searches, not yet taken.
+  std::vector<counterexamplet> shared_counterexamples;
+
+  /// A neighbourhood explored by a child process, which reports its result
+  /// through a pipe, and receives the counterexamples found elsewhere
+  /// through another.
+  struct jobt
+  {
+    int pid;
+    int fd;
+    int to_child;
+    std::size_t neighbourhood;
+
+    /// Counterexamples not yet written to to_child, framed.
+    std::string pending;
+  };
+
+  std::vector<jobt> running_jobs;
+
+  /// Explores the given neighbourhood in a child process, in rounds of
+  /// max_local_iterations, until a round makes no progress.
+  void start_job(std::size_t neighbourhood);
+
+  /// The exploration in the child process. Between rounds, adds the
+  /// counterexamples received on input to the learner.
+  void run_job(neighbourhoodt &, int input);
+
+  /// Reads the results of the jobs that have finished.
+  void collect_jobs();
+
+  /// Writes as much of the pending counterexamples to the jobs as the
+  /// pipes take without blocking.
+  void flush_jobs();
+
+  /// Terminates all jobs.
+  void cancel_jobs();
+
 public:
   /// Solution to the original CEGIS problem, if found.
   solutiont solution;
 
+  /// Statistics of the SMT queries of constant_limitst, including those of
+  /// the jobs.
+  solver_statisticst solver_statistics;
+
   /// \see incremental_solver_learnt
   bool incremental_solving;
 
@@ -100,6 +206,21 @@ public:
   /// \see cegist::logic
   std::string logic;
 
+  /// Number of child processes exploring neighbourhoods concurrently with
+  /// the caller, each until it is complete or stops making progress. The
+  /// first solution found cancels the others. With 0, neighbourhoods are
+  /// explored for a limited number of iterations in operator(). Writing to
+  /// a job that has ended raises SIGPIPE, which the caller must ignore.
+  std::size_t jobs;
+
+  /// Search constants with constant_synthesist instead of constant_limitst
+  /// and a general learner.
+  bool use_constant_synthesis;
+
+  /// Maximum number of neighbourhood learners kept alive, 0 for no limit.
+  /// Each may hold a SAT solver.
+  std::size_t max_learners;
+
   /// Creates a local search which can explore solution equivalence classes
   /// for the given CEGIS problem.
   /// \param ns \see local_cegist::ns
@@ -107,9 +228,24 @@ public:
   /// \param problem \see local_cegist::problem
   local_cegist(const namespacet &ns, verifyt &verify, const problemt &problem);
 
-  /// Execute a limited number of local CEGIS iterations.
+  /// Terminates the running jobs.
+  ~local_cegist();
+
+  /// Execute a limited number of local CEGIS iterations on the most
+  /// promising open neighbourhood, or, with jobs, start exploring it in the
+  /// background.
   void operator()();
 
+  /// Counterexamples found by jobs since the last call.
+  std::vector<counterexamplet> take_counterexamples();
+
+  /// Passes a counterexample found by the caller to the running jobs.
+  void share_counterexample(const counterexamplet &);
+
+  /// Indicates whether create_learner() creates a constant_synthesist,
+  /// which searches the constants itself, hence without constant_limitst.
+  bool uses_constant_synthesis() const;
+
   /// Create a CEGIS default learner instance using the given configuration.
   /// \return Configured CEGIS learner.
   std::unique_ptr<learnt> create_learner();
@@ -129,6 +265,19 @@ public:
 
   /// Indicates whether a solution to the overall CEGIS problem was found.
   bool has_solution();
+
+  /// Number of neighbourhoods that have been or are being explored.
+  std::size_t number_of_neighbourhoods() const
+  {
+    return solutions.size();
+  }
+
+  /// Number of neighbourhoods holding a learner.
+  std::size_t number_of_learners() const;
+
+  /// Sizes of the constraints and learner expressions held for all
+  /// neighbourhoods.
+  irep_statisticst expression_statistics() const;
 };
 
 #endif /* CPROVER_FASTSYNTH_LOCAL_CEGIS_H_ */
@@ -88,7 +88,7 @@ public:
 /// Prefix for synthesis function parameter names.
 #define PARAM_PREFIX "synth::parameter"
 
-exprt local_synth_encodingt::operator()(const exprt &expr)
+exprt local_synth_encodingt::encode(const exprt &expr)
 {
   // Add extra constraints first, only once.
   const bool add_extra_constraints=constraints.empty();
@@ -157,7 +157,7 @@ exprt local_synth_encodingt::operator()(const exprt &expr)
     }
     return result;
   }
-  return synth_encodingt::operator()(expr);
+  return synth_encodingt::encode(expr);
 }
 
 namespace
@@ -29,11 +29,12 @@ public:
     const solutiont &solution_template,
     const synth_encodingt::constraintst &extra_constraints);
 
-  /// \see synth_encodingt::operator()(const exprt &)
-  exprt operator()(const exprt &) override;
-
   /// \see get_expressions(const decision_proceduret &)
   solutiont get_solution(const decision_proceduret &) const override;
+
+protected:
+  /// \see synth_encodingt::encode(const exprt &)
+  exprt encode(const exprt &) override;
 };
 
 /// Creates a constant placeholder variable.
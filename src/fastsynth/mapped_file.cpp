@@ -0,0 +1,75 @@
+#include "mapped_file.h"
+
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+mapped_filet::mapped_filet(const std::string &file_name):
+  valid(false),
+  mapped(false),
+  begin(nullptr),
+  length(0)
+{
+#ifndef _WIN32
+  const int fd=::open(file_name.c_str(), O_RDONLY);
+  if(fd==-1)
+    return;
+
+  // directories and devices are not inputs, and reading a directory
+  // succeeds on some systems
+  struct stat file_stat;
+  if(fstat(fd, &file_stat)!=0 || !S_ISREG(file_stat.st_mode))
+  {
+    close(fd);
+    return;
+  }
+
+  if(file_stat.st_size>0)
+  {
+    void *const data=mmap(
+      nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if(data!=MAP_FAILED)
+    {
+      // the file is read front to back
+      madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+
+      valid=true;
+      mapped=true;
+      begin=static_cast<const char *>(data);
+      length=file_stat.st_size;
+    }
+  }
+
+  close(fd);
+
+  if(valid)
+    return;
+#endif
+
+  // empty files cannot be mapped, and mapping may fail
+  std::ifstream in(file_name, std::ios::binary);
+  if(!in)
+    return;
+
+  contents.assign(
+    std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+  valid=true;
+  begin=contents.data();
+  length=contents.size();
+}
+
+mapped_filet::~mapped_filet()
+{
+#ifndef _WIN32
+  if(mapped)
+    munmap(const_cast<char *>(begin), length);
+#endif
+}
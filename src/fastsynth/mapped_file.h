@@ -0,0 +1,44 @@
+#ifndef CPROVER_FASTSYNTH_MAPPED_FILE_H_
+#define CPROVER_FASTSYNTH_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+/// Read-only contents of a regular file, mapped into memory where supported
+/// and read into a buffer otherwise.
+class mapped_filet
+{
+public:
+  explicit mapped_filet(const std::string &file_name);
+  ~mapped_filet();
+
+  mapped_filet(const mapped_filet &)=delete;
+  mapped_filet &operator=(const mapped_filet &)=delete;
+
+  /// \return false if the file could not be read
+  bool is_open() const
+  {
+    return valid;
+  }
+
+  const char *data() const
+  {
+    return begin;
+  }
+
+  std::size_t size() const
+  {
+    return length;
+  }
+
+protected:
+  bool valid;
+  bool mapped;
+  const char *begin;
+  std::size_t length;
+
+  /// The contents where the file is not mapped.
+  std::string contents;
+};
+
+#endif /* CPROVER_FASTSYNTH_MAPPED_FILE_H_ */
@@ -0,0 +1,113 @@
+#include "memory_statistics.h"
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+std::size_t peak_rss_kb()
+{
+#ifdef _WIN32
+  return 0;
+#else
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage)!=0)
+    return 0;
+
+#ifdef __APPLE__
+  // bytes rather than KB
+  return usage.ru_maxrss/1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#endif
+}
+
+std::ostream &operator<<(std::ostream &out, const irep_statisticst &s)
+{
+  bool first=true;
+
+  for(const auto &c : s)
+  {
+    if(first)
+      first=false;
+    else
+      out << ", ";
+
+    out << c.first << ' '
+        << c.second.tree_nodes << " nodes ("
+        << c.second.dag_nodes << " distinct)";
+  }
+
+  return out;
+}
+
+static std::size_t saturating_add(std::size_t a, std::size_t b)
+{
+  const std::size_t max=std::numeric_limits<std::size_t>::max();
+  return a>max-b ? max : a+b;
+}
+
+std::size_t irep_countert::subtree_size(const irept &irep)
+{
+  const void *node=&irep.read();
+
+  const auto entry=subtree_sizes.find(node);
+  if(entry!=subtree_sizes.end())
+    return entry->second;
+
+  std::size_t size=1;
+
+  for(const auto &sub : irep.get_sub())
+    size=saturating_add(size, subtree_size(sub));
+
+  for(const auto &named_sub : irep.get_named_sub())
+    size=saturating_add(size, subtree_size(named_sub.second));
+
+  subtree_sizes.emplace(node, size);
+  return size;
+}
+
+void irep_countert::operator()(const irept &irep)
+{
+  roots.push_back(irep);
+  tree_nodes=saturating_add(tree_nodes, subtree_size(irep));
+}
+
+void memory_phasest::end_phase(const std::string &phase)
+{
+  const std::size_t peak=peak_rss_kb();
+  const std::size_t growth=peak>last_peak_kb ? peak-last_peak_kb : 0;
+  last_peak_kb=std::max(last_peak_kb, peak);
+
+  const auto entry=std::find_if(
+    growth_kb.begin(),
+    growth_kb.end(),
+    [&phase](const std::pair<std::string, std::size_t> &p)
+    {
+      return p.first==phase;
+    });
+
+  if(entry==growth_kb.end())
+    growth_kb.emplace_back(phase, growth);
+  else
+    entry->second+=growth;
+}
+
+void memory_phasest::output(std::ostream &out) const
+{
+  out << "Peak memory: " << peak_rss_kb() << " KB";
+
+  for(const auto &p : growth_kb)
+    out << "\nPeak memory growth in " << p.first << ": "
+        << p.second << " KB";
+}
+
+memory_phasest &global_memory_phases()
+{
+  static memory_phasest memory_phases;
+  return memory_phases;
+}
@@ -0,0 +1,100 @@
+#ifndef CPROVER_FASTSYNTH_MEMORY_STATISTICS_H_
+#define CPROVER_FASTSYNTH_MEMORY_STATISTICS_H_
+
+#include <util/irep.h>
+
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// High-water mark of the resident set size of this process in KB, or zero if
+/// the platform does not report it.
+std::size_t peak_rss_kb();
+
+/// Number of irep nodes in a set of expressions.
+struct irep_countst
+{
+  irep_countst():tree_nodes(0), dag_nodes(0)
+  {
+  }
+
+  /// Nodes as if every shared subtree were copied.
+  std::size_t tree_nodes;
+
+  /// Distinct nodes actually held in memory.
+  std::size_t dag_nodes;
+
+  irep_countst &operator+=(const irep_countst &other)
+  {
+    tree_nodes+=other.tree_nodes;
+    dag_nodes+=other.dag_nodes;
+    return *this;
+  }
+};
+
+/// Node counts by the name of the container holding the expressions.
+using irep_statisticst=std::map<std::string, irep_countst>;
+
+std::ostream &operator<<(std::ostream &, const irep_statisticst &);
+
+/// Counts irep nodes with and without sharing. Nodes are identified by the
+/// address of their shared data; the counter keeps a reference to each irep
+/// passed to it so that these addresses are not reused.
+class irep_countert
+{
+public:
+  irep_countert():tree_nodes(0)
+  {
+  }
+
+  /// Adds the nodes of the given irep. Nodes shared with previously added
+  /// ireps contribute to the tree count again, but not to the DAG count.
+  void operator()(const irept &);
+
+  irep_countst get() const
+  {
+    irep_countst result;
+    result.tree_nodes=tree_nodes;
+    result.dag_nodes=subtree_sizes.size();
+    return result;
+  }
+
+protected:
+  std::size_t tree_nodes;
+  std::vector<irept> roots;
+
+  /// Tree size of each visited node, saturating at SIZE_MAX.
+  std::unordered_map<const void *, std::size_t> subtree_sizes;
+
+  std::size_t subtree_size(const irept &);
+};
+
+/// Attributes the growth of the resident set high-water mark to the phases
+/// of a run.
+class memory_phasest
+{
+public:
+  memory_phasest():last_peak_kb(0)
+  {
+  }
+
+  /// Attributes the growth since the end of the previous phase to the given
+  /// phase.
+  void end_phase(const std::string &phase);
+
+  /// Writes one line per phase and the overall peak.
+  void output(std::ostream &) const;
+
+protected:
+  std::size_t last_peak_kb;
+
+  /// Growth in KB, in order of the first occurrence of each phase.
+  std::vector<std::pair<std::string, std::size_t>> growth_kb;
+};
+
+/// The phase accounting shared by all components of fastsynth.
+memory_phasest &global_memory_phases();
+
+#endif /* CPROVER_FASTSYNTH_MEMORY_STATISTICS_H_ */
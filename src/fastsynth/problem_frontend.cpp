@@ -0,0 +1,102 @@
+#include "problem_frontend.h"
+#include "problem_serialization.h"
+#include "cegis.h"
+#include "cegis_options.h"
+
+#include <util/cout_message.h>
+#include <util/namespace.h>
+#include <util/symbol_table.h>
+#include <util/config.h>
+#include <util/prefix.h>
+
+#include <ansi-c/ansi_c_language.h>
+
+#include <langapi/language_util.h>
+#include <langapi/mode.h>
+
+#include <chrono>
+
+int problem_frontend(const cmdlinet &cmdline)
+{
+  register_language(new_ansi_c_language);
+  config.ansi_c.set_32();
+
+  console_message_handlert message_handler;
+  messaget message(message_handler);
+
+  // this is our default verbosity
+  unsigned int v=messaget::M_STATISTICS;
+
+  if(cmdline.isset("verbosity"))
+  {
+    v=std::stol(
+        cmdline.get_value("verbosity"));
+    if(v>10)
+      v=10;
+  }
+
+  message_handler.set_verbosity(v);
+
+  problemt problem;
+  std::string logic;
+  symbol_tablet symbol_table;
+
+  if(!read_problem_file(
+       cmdline.get_value("load-problem"), problem, logic, symbol_table))
+  {
+    message.error() << "Failed to read problem file" << messaget::eom;
+    return 10;
+  }
+
+  // the symbols the problem refers to in its front end
+  namespacet ns(symbol_table);
+  cegist cegis(ns);
+  cegis.set_message_handler(message_handler);
+
+  set_cegis_options(cmdline, cegis);
+  cegis.logic=logic;
+
+  auto start_time=std::chrono::steady_clock::now();
+
+  switch(cegis(problem))
+  {
+  case decision_proceduret::resultt::D_SATISFIABLE:
+
+    for(const auto &f : cegis.solution.functions)
+    {
+      // functions of SyGuS problems carry the prefix of their parser
+      std::string name=id2string(f.first.get_identifier());
+      if(has_prefix(name, "synth_fun::"))
+        name=std::string(name, std::string("synth_fun::").size());
+
+      message.result() << "Result: "
+                       << name
+                       << " -> "
+                       << from_expr(ns, "", f.second)
+                       << '\n';
+    }
+
+    message.result() << messaget::eom;
+
+    message.statistics() << "Synthesis time: "
+                         << std::chrono::duration<double>(
+                              std::chrono::steady_clock::now()-start_time).count()
+                         << 's'
+                         << messaget::eom;
+
+    message.statistics() << "Synthesis solver: "
+                         << cegis.synthesis_statistics
+                         << messaget::eom;
+
+    message.statistics() << "Verification solver: "
+                         << cegis.verification_statistics
+                         << messaget::eom;
+    break;
+
+  case decision_proceduret::resultt::D_UNSATISFIABLE:
+  case decision_proceduret::resultt::D_ERROR:
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,4 @@
+#include <util/cmdline.h>
+
+/// Runs CEGIS on a problem written by --dump-problem.
+int problem_frontend(const cmdlinet &);
@@ -0,0 +1,354 @@
+#include <fastsynth/problem_serialization.h>
+#include <fastsynth/mapped_file.h>
+
+#include <util/find_symbols.h>
+#include <util/irep_serialization.h>
+#include <util/namespace.h>
+#include <util/ssa_expr.h>
+#include <util/symbol_table.h>
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+/// Identifies the format, to be changed whenever it changes.
+static const char problem_header[] = "FSPROB2";
+
+template <typename containert>
+static void write_exprs(
+  std::ostream &out,
+  irep_serializationt &serializer,
+  const containert &exprs)
+{
+  irep_serializationt::write_gb_word(out, exprs.size());
+  for(const exprt &e : exprs)
+    serializer.reference_convert(e, out);
+}
+
+/// Reads expressions written by write_exprs, passing each to `add`.
+template <typename addt>
+static bool
+read_exprs(std::istream &in, irep_serializationt &serializer, addt add)
+{
+  const std::size_t size = irep_serializationt::read_gb_word(in);
+  for(std::size_t i = 0; i < size && in; ++i)
+  {
+    irept irep;
+    serializer.reference_convert(in, irep);
+    add(static_cast<const exprt &>(irep));
+  }
+  return bool(in);
+}
+
+template <typename mapt>
+static void write_map(
+  std::ostream &out,
+  irep_serializationt &serializer,
+  const mapt &map)
+{
+  irep_serializationt::write_gb_word(out, map.size());
+  for(const auto &entry : map)
+  {
+    serializer.reference_convert(entry.first, out);
+    serializer.reference_convert(entry.second, out);
+  }
+}
+
+/// Reads a map written by write_map, whose keys are of type `keyt`.
+template <typename keyt, typename mapt>
+static bool
+read_map(std::istream &in, irep_serializationt &serializer, mapt &map)
+{
+  const std::size_t size = irep_serializationt::read_gb_word(in);
+  for(std::size_t i = 0; i < size && in; ++i)
+  {
+    irept key, value;
+    serializer.reference_convert(in, key);
+    serializer.reference_convert(in, value);
+    map[static_cast<const keyt &>(key)] = static_cast<const exprt &>(value);
+  }
+  return bool(in);
+}
+
+/// The flags of a symbol, in the order in which write_symbols writes them.
+static std::vector<bool symbolt::*> symbol_flags()
+{
+  return {&symbolt::is_type,
+          &symbolt::is_macro,
+          &symbolt::is_exported,
+          &symbolt::is_input,
+          &symbolt::is_output,
+          &symbolt::is_state_var,
+          &symbolt::is_property,
+          &symbolt::is_parameter,
+          &symbolt::is_auxiliary,
+          &symbolt::is_weak,
+          &symbolt::is_lvalue,
+          &symbolt::is_static_lifetime,
+          &symbolt::is_thread_local,
+          &symbolt::is_file_local,
+          &symbolt::is_extern,
+          &symbolt::is_volatile};
+}
+
+static void write_symbols(
+  std::ostream &out,
+  irep_serializationt &serializer,
+  const symbol_tablet &symbol_table)
+{
+  const auto flags = symbol_flags();
+
+  irep_serializationt::write_gb_word(out, symbol_table.symbols.size());
+  for(const auto &entry : symbol_table.symbols)
+  {
+    const symbolt &symbol = entry.second;
+
+    serializer.reference_convert(symbol.type, out);
+    serializer.reference_convert(symbol.value, out);
+    serializer.reference_convert(symbol.location, out);
+    serializer.write_string_ref(out, symbol.name);
+    serializer.write_string_ref(out, symbol.module);
+    serializer.write_string_ref(out, symbol.base_name);
+    serializer.write_string_ref(out, symbol.mode);
+    serializer.write_string_ref(out, symbol.pretty_name);
+
+    std::size_t flag_bits = 0;
+    for(std::size_t i = 0; i < flags.size(); ++i)
+      if(symbol.*flags[i])
+        flag_bits |= std::size_t(1) << i;
+    irep_serializationt::write_gb_word(out, flag_bits);
+  }
+}
+
+/// Adds the symbols written by write_symbols to the symbol table.
+static bool read_symbols(
+  std::istream &in,
+  irep_serializationt &serializer,
+  symbol_tablet &symbol_table)
+{
+  const auto flags = symbol_flags();
+
+  const std::size_t size = irep_serializationt::read_gb_word(in);
+  for(std::size_t i = 0; i < size && in; ++i)
+  {
+    symbolt symbol;
+    irept type, value, location;
+
+    serializer.reference_convert(in, type);
+    serializer.reference_convert(in, value);
+    serializer.reference_convert(in, location);
+    symbol.type = static_cast<const typet &>(type);
+    symbol.value = static_cast<const exprt &>(value);
+    symbol.location = static_cast<const source_locationt &>(location);
+    symbol.name = serializer.read_string_ref(in);
+    symbol.module = serializer.read_string_ref(in);
+    symbol.base_name = serializer.read_string_ref(in);
+    symbol.mode = serializer.read_string_ref(in);
+    symbol.pretty_name = serializer.read_string_ref(in);
+
+    const std::size_t flag_bits = irep_serializationt::read_gb_word(in);
+    for(std::size_t f = 0; f < flags.size(); ++f)
+      symbol.*flags[f] = (flag_bits & (std::size_t(1) << f)) != 0;
+
+    if(in)
+      symbol_table.insert(std::move(symbol));
+  }
+
+  return bool(in);
+}
+
+void write_problem(
+  std::ostream &out,
+  const problemt &problem,
+  const std::string &logic,
+  const symbol_tablet &symbols)
+{
+  irep_serializationt::ireps_containert ireps_container;
+  irep_serializationt serializer(ireps_container);
+
+  out.write(problem_header, sizeof(problem_header));
+  serializer.write_string_ref(out, logic);
+  write_symbols(out, serializer, symbols);
+  write_exprs(out, serializer, problem.free_variables);
+  write_exprs(out, serializer, problem.side_conditions);
+  write_exprs(out, serializer, problem.constraints);
+  write_exprs(out, serializer, problem.literals);
+}
+
+bool read_problem(
+  std::istream &in,
+  problemt &problem,
+  std::string &logic,
+  symbol_tablet &symbols)
+{
+  char header[sizeof(problem_header)];
+  if(
+    !in.read(header, sizeof(header)) ||
+    !std::equal(header, header + sizeof(header), problem_header))
+  {
+    return false;
+  }
+
+  irep_serializationt::ireps_containert ireps_container;
+  irep_serializationt serializer(ireps_container);
+
+  const std::string result_logic = id2string(serializer.read_string_ref(in));
+
+  symbol_tablet result_symbols;
+  problemt result;
+
+  const bool success =
+    read_symbols(in, serializer, result_symbols) &&
+    read_exprs(
+      in,
+      serializer,
+      [&result](const exprt &e) { result.free_variables.insert(e); }) &&
+    read_exprs(
+      in,
+      serializer,
+      [&result](const exprt &e) { result.side_conditions.push_back(e); }) &&
+    read_exprs(
+      in,
+      serializer,
+      [&result](const exprt &e) { result.constraints.push_back(e); }) &&
+    read_exprs(
+      in,
+      serializer,
+      [&result](const exprt &e) {
+        result.literals.insert(to_constant_expr(e));
+      });
+
+  if(success)
+  {
+    problem = std::move(result);
+    logic = result_logic;
+    symbols.swap(result_symbols);
+  }
+
+  return success;
+}
+
+void collect_problem_symbols(
+  const namespacet &ns,
+  const problemt &problem,
+  symbol_tablet &dest)
+{
+  find_symbols_sett identifiers;
+
+  const auto collect = [&identifiers](const exprt &expr) {
+    find_type_and_expr_symbols(expr, identifiers);
+
+    // SSA symbols are named after the object they rename
+    expr.visit_pre([&identifiers](const exprt &e) {
+      if(is_ssa_expr(e))
+        identifiers.insert(to_ssa_expr(e).get_object_name());
+    });
+  };
+
+  for(const exprt &e : problem.free_variables)
+    collect(e);
+  for(const exprt &e : problem.side_conditions)
+    collect(e);
+  for(const exprt &e : problem.constraints)
+    collect(e);
+
+  std::vector<irep_idt> worklist(identifiers.begin(), identifiers.end());
+
+  while(!worklist.empty())
+  {
+    const irep_idt identifier = worklist.back();
+    worklist.pop_back();
+
+    const symbolt *symbol;
+    if(dest.has_symbol(identifier) || ns.lookup(identifier, symbol))
+      continue;
+
+    dest.insert(*symbol);
+
+    // tags referred to by the type, e.g., of struct members
+    find_symbols_sett type_identifiers;
+    find_type_and_expr_symbols(symbol->type, type_identifiers);
+    worklist.insert(
+      worklist.end(), type_identifiers.begin(), type_identifiers.end());
+  }
+}
+
+namespace
+{
+/// Stream buffer reading from memory, e.g., a mapped file.
+class memory_streambuft : public std::streambuf
+{
+public:
+  memory_streambuft(const char *data, std::size_t size)
+  {
+    char *begin = const_cast<char *>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+}
+
+bool write_problem_file(
+  const std::string &file_name,
+  const namespacet &ns,
+  const problemt &problem,
+  const std::string &logic)
+{
+  symbol_tablet symbols;
+  collect_problem_symbols(ns, problem, symbols);
+
+  std::ofstream out(file_name, std::ios::binary);
+  write_problem(out, problem, logic, symbols);
+  return bool(out);
+}
+
+bool read_problem_file(
+  const std::string &file_name,
+  problemt &problem,
+  std::string &logic,
+  symbol_tablet &symbols)
+{
+  const mapped_filet file(file_name);
+  if(!file.is_open())
+    return false;
+
+  memory_streambuft buffer(file.data(), file.size());
+  std::istream in(&buffer);
+  return read_problem(in, problem, logic, symbols);
+}
+
+void write_solution(
+  std::ostream &out,
+  irep_serializationt &serializer,
+  const solutiont &solution)
+{
+  write_map(out, serializer, solution.functions);
+  write_map(out, serializer, solution.s_functions);
+}
+
+bool read_solution(
+  std::istream &in,
+  irep_serializationt &serializer,
+  solutiont &solution)
+{
+  return read_map<symbol_exprt>(in, serializer, solution.functions) &&
+         read_map<symbol_exprt>(in, serializer, solution.s_functions);
+}
+
+void write_counterexample(
+  std::ostream &out,
+  irep_serializationt &serializer,
+  const counterexamplet &counterexample)
+{
+  write_map(out, serializer, counterexample.assignment);
+}
+
+bool read_counterexample(
+  std::istream &in,
+  irep_serializationt &serializer,
+  counterexamplet &counterexample)
+{
+  return read_map<exprt>(in, serializer, counterexample.assignment);
+}
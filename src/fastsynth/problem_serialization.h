@@ -0,0 +1,82 @@
+#ifndef CPROVER_FASTSYNTH_PROBLEM_SERIALIZATION_H_
+#define CPROVER_FASTSYNTH_PROBLEM_SERIALIZATION_H_
+
+#include <fastsynth/cegis_types.h>
+
+#include <iosfwd>
+#include <string>
+
+class irep_serializationt;
+class namespacet;
+class symbol_tablet;
+
+/// Writes the problem in a compact binary form, behind a versioned header,
+/// together with its logic and the symbols it refers to. Expressions are
+/// written by irep_serializationt, which writes shared subexpressions and
+/// identifiers once and refers to them by number.
+void write_problem(
+  std::ostream &,
+  const problemt &,
+  const std::string &logic,
+  const symbol_tablet &symbols);
+
+/// Reads a problem written by write_problem.
+/// \return false if the input is not a problem in the current format
+bool read_problem(
+  std::istream &,
+  problemt &,
+  std::string &logic,
+  symbol_tablet &symbols);
+
+/// Collects the symbols the problem refers to, which includes the objects
+/// of SSA symbols and the tags in types, transitively, such that the
+/// problem can be used without the symbol table of its front end.
+void collect_problem_symbols(
+  const namespacet &,
+  const problemt &,
+  symbol_tablet &dest);
+
+/// Writes the problem to a file, with the symbols it refers to in the
+/// given namespace, \see write_problem.
+/// \return false if the file could not be written
+bool write_problem_file(
+  const std::string &file_name,
+  const namespacet &,
+  const problemt &,
+  const std::string &logic);
+
+/// Reads a problem file written by write_problem, mapping it into memory
+/// where supported.
+/// \return false if the file cannot be read or is not a problem in the
+///   current format
+bool read_problem_file(
+  const std::string &file_name,
+  problemt &,
+  std::string &logic,
+  symbol_tablet &symbols);
+
+/// Writes a solution as part of a larger stream. Expressions shared with
+/// earlier parts written by the same serializer are written once.
+void write_solution(
+  std::ostream &,
+  irep_serializationt &,
+  const solutiont &);
+
+/// Reads a solution written by write_solution.
+/// \return false on read errors
+bool read_solution(std::istream &, irep_serializationt &, solutiont &);
+
+/// Writes a counterexample as part of a larger stream, \see write_solution.
+void write_counterexample(
+  std::ostream &,
+  irep_serializationt &,
+  const counterexamplet &);
+
+/// Reads a counterexample written by write_counterexample.
+/// \return false on read errors
+bool read_counterexample(
+  std::istream &,
+  irep_serializationt &,
+  counterexamplet &);
+
+#endif /* CPROVER_FASTSYNTH_PROBLEM_SERIALIZATION_H_ */
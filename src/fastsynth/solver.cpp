@@ -1,9 +1,57 @@
 #include "solver.h"
+#include "solver_statistics.h"
 
 #include <solvers/sat/satcheck.h>
 #include <solvers/flattening/bv_pointers.h>
 #include <solvers/smt2/smt2_dec.h>
 
+#ifdef HAVE_MINISAT2
+#include <minisat/simp/SimpSolver.h>
+
+/// MiniSat back end that exposes the search counters of the solver.
+template <class satcheck_baset>
+class counting_satcheckt:public satcheck_baset, public sat_countert
+{
+public:
+  explicit counting_satcheckt(message_handlert &message_handler):
+    satcheck_baset(message_handler)
+  {
+  }
+
+  void get_counters(solver_statisticst &dest) const override
+  {
+    dest.conflicts=this->solver->conflicts;
+    dest.decisions=this->solver->decisions;
+    dest.propagations=this->solver->propagations;
+    dest.restarts=this->solver->starts;
+  }
+};
+
+std::unique_ptr<propt> new_satcheck(message_handlert &message_handler)
+{
+  return std::unique_ptr<propt>(
+    new counting_satcheckt<satcheck_minisat_simplifiert>(message_handler));
+}
+
+std::unique_ptr<propt> new_satcheck_no_simplifier(
+  message_handlert &message_handler)
+{
+  return std::unique_ptr<propt>(
+    new counting_satcheckt<satcheck_minisat_no_simplifiert>(message_handler));
+}
+#else
+std::unique_ptr<propt> new_satcheck(message_handlert &message_handler)
+{
+  return std::unique_ptr<propt>(new satcheckt(message_handler));
+}
+
+std::unique_ptr<propt> new_satcheck_no_simplifier(
+  message_handlert &message_handler)
+{
+  return std::unique_ptr<propt>(new satcheck_no_simplifiert(message_handler));
+}
+#endif
+
 solvert::solvert(
   bool use_smt,
   const std::string &logic,
@@ -19,7 +67,7 @@ solvert::solvert(
   }
   else
   {
-    prop=std::unique_ptr<propt>(new satcheckt(message_handler));
+    prop=new_satcheck(message_handler);
 
     decision_procedure=std::unique_ptr<decision_proceduret>(
       new bv_pointerst(_ns, *prop, message_handler));
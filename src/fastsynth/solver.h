@@ -1,3 +1,6 @@
+#ifndef CPROVER_FASTSYNTH_SOLVER_H_
+#define CPROVER_FASTSYNTH_SOLVER_H_
+
 #include <util/namespace.h>
 
 #include <solvers/decision_procedure.h>
@@ -13,6 +16,12 @@ public:
     return *decision_procedure;
   }
 
+  /// Propositional back end, or `nullptr` when using SMT.
+  const propt *get_prop() const
+  {
+    return prop.get();
+  }
+
   solvert(
     bool use_smt,
     const std::string &logic,
@@ -23,3 +32,13 @@ protected:
   std::unique_ptr<propt> prop;
   std::unique_ptr<decision_proceduret> decision_procedure;
 };
+
+/// Creates the default SAT back end (with simplifier). The back end reports
+/// search counters to solve(decision_proceduret &, const propt *,
+/// solver_statisticst &) where supported.
+std::unique_ptr<propt> new_satcheck(message_handlert &);
+
+/// Creates the SAT back end without simplifier, e.g. for incremental use.
+std::unique_ptr<propt> new_satcheck_no_simplifier(message_handlert &);
+
+#endif /* CPROVER_FASTSYNTH_SOLVER_H_ */
@@ -1,12 +1,9 @@
-#include <solvers/flattening/bv_pointers.h>
-#include <solvers/sat/satcheck.h>
-
-#include <solvers/smt2/smt2_dec.h>
-
 #include <langapi/language_util.h>
 
 #include "synth_encoding.h"
+#include "solver.h"
 #include "solver_learn.h"
+#include "trace.h"
 
 solver_learn_baset::solver_learn_baset(
   const namespacet &_ns,
@@ -25,35 +22,65 @@ void solver_learn_baset::add_counterexample(
   synth_encodingt &synth_encoding,
   decision_proceduret &solver)
 {
-  for(const auto &it : ce.assignment)
+  exprt::operandst encoded_ce;
+
   {
-    const exprt &symbol = it.first;
-    const exprt &value = it.second;
+    trace_scopet trace_scope("encoding", "synthesis");
 
-    exprt encoded = synth_encoding(equal_exprt(symbol, value));
-    debug() << "ce: " << from_expr(ns, "", encoded) << eom;
-    solver.set_to_true(encoded);
+    for(const auto &it : ce.assignment)
+    {
+      const exprt &symbol = it.first;
+      const exprt &value = it.second;
+
+      encoded_ce.push_back(synth_encoding(equal_exprt(symbol, value)));
+      if(message_handler && get_message_handler().get_verbosity() >= M_DEBUG)
+        debug() << "ce: " << from_expr(ns, "", encoded_ce.back()) << eom;
+    }
   }
+
+  count_expressions("encoded constraints", encoded_ce);
+
+  trace_scopet trace_scope("bit-blasting", "synthesis");
+
+  for(const exprt &e : encoded_ce)
+    solver.set_to_true(e);
 }
 
 void solver_learn_baset::add_problem(
   synth_encodingt &encoding,
   decision_proceduret &solver)
 {
-  for(const exprt &e : problem.side_conditions)
-  {
-    const exprt encoded = encoding(e);
-    debug() << "sc: " << from_expr(ns, "", encoded) << eom;
-    solver.set_to_true(encoded);
-  }
+  exprt::operandst encoded_problem;
 
-  for(const auto &e : problem.constraints)
   {
-    const exprt encoded = encoding(e);
-    debug() << "co: " << from_expr(ns, "", encoded) << eom;
-    solver.set_to_true(encoded);
+    trace_scopet trace_scope("encoding", "synthesis");
+
+    for(const exprt &e : problem.side_conditions)
+    {
+      encoded_problem.push_back(encoding(e));
+      // printing the tree of shared terms takes exponential time
+      if(message_handler && get_message_handler().get_verbosity() >= M_DEBUG)
+        debug() << "sc: " << from_expr(ns, "", encoded_problem.back()) << eom;
+    }
+
+    for(const auto &e : problem.constraints)
+    {
+      encoded_problem.push_back(encoding(e));
+      if(message_handler && get_message_handler().get_verbosity() >= M_DEBUG)
+        debug() << "co: " << from_expr(ns, "", encoded_problem.back()) << eom;
+    }
   }
 
+  count_expressions("encoded constraints", encoded_problem);
+  count_expressions(
+    "instruction constraints",
+    exprt::operandst(encoding.constraints.begin(), encoding.constraints.end()));
+
+  trace_scopet trace_scope("bit-blasting", "synthesis");
+
+  for(const exprt &e : encoded_problem)
+    solver.set_to_true(e);
+
   for(const auto &c : encoding.constraints)
   {
     solver.set_to_true(c);
@@ -64,6 +91,26 @@ void solver_learn_baset::add_problem(
   }
 }
 
+void solver_learn_baset::count_expressions(
+  const std::string &kind,
+  const exprt::operandst &expressions)
+{
+  if(!message_handler ||
+     get_message_handler().get_verbosity()<M_STATISTICS)
+    return;
+
+  irep_countert &counter=expression_counters[kind];
+  for(const auto &e : expressions)
+    counter(e);
+}
+
+void solver_learn_baset::update_expression_statistics()
+{
+  expression_statistics.clear();
+  for(const auto &c : expression_counters)
+    expression_statistics[c.first]=c.second.get();
+}
+
 solver_learnt::solver_learnt(
   const namespacet &_ns,
   const problemt &_problem,
@@ -82,28 +129,18 @@ void solver_learnt::set_program_size(const size_t program_size)
 
 decision_proceduret::resultt solver_learnt::operator()()
 {
-  if(use_smt)
-  {
-    smt2_dect solver(
-      ns, "fastsynth", "generated by fastsynth",
-      logic, smt2_dect::solvert::Z3);
-    solver.set_message_handler(get_message_handler());
-
-    return this->operator()(solver);
-  }
-  else
-  {
-    satcheckt satcheck(get_message_handler());
-
-    bv_pointerst solver(ns, satcheck, get_message_handler());
-
-    return this->operator()(solver);
-  }
+  solvert solver_container(use_smt, logic, ns, get_message_handler());
+  return this->operator()(
+    solver_container.get(), solver_container.get_prop());
 }
 
 decision_proceduret::resultt solver_learnt::operator()(
-  decision_proceduret &solver)
+  decision_proceduret &solver,
+  const propt *prop)
 {
+  solver_statistics.clear();
+  expression_counters.clear();
+
   const std::unique_ptr<synth_encodingt> synth_enc(synth_encoding_factory());
   synth_enc->program_size = program_size;
   synth_enc->enable_bitwise = enable_bitwise;
@@ -131,7 +168,15 @@ decision_proceduret::resultt solver_learnt::operator()(
     }
   }
 
-  const decision_proceduret::resultt result=solver();
+  update_expression_statistics();
+  expression_counters.clear();
+
+  decision_proceduret::resultt result;
+
+  {
+    trace_scopet trace_scope("SAT solving", "synthesis");
+    result=solve(solver, prop, solver_statistics);
+  }
 
   switch(result)
   {
@@ -32,6 +32,17 @@ protected:
   /// \param solver Solver instance.
   void add_problem(synth_encodingt &, decision_proceduret &);
 
+  /// Counters behind learnt::expression_statistics. These live as long as
+  /// the solver that received the expressions.
+  std::map<std::string, irep_countert> expression_counters;
+
+  /// Adds the given expressions to the counter of the given kind, if
+  /// statistics are enabled.
+  void count_expressions(const std::string &kind, const exprt::operandst &);
+
+  /// Copies the counters to learnt::expression_statistics.
+  void update_expression_statistics();
+
   /// Creates the base class.
   /// \param ns \see ns solver_learnt::ns
   /// \param problem \see solver_learnt::problem
@@ -81,7 +92,12 @@ public:
   decision_proceduret::resultt operator()() override;
 
   /// \see learnt::operator()()
-  decision_proceduret::resultt operator()(decision_proceduret &);
+  /// \param solver Decision procedure to add the constraint to.
+  /// \param prop Propositional back end of `solver`, or `nullptr` if there is
+  ///   none. Used for statistics only.
+  decision_proceduret::resultt operator()(
+    decision_proceduret &solver,
+    const propt *prop = nullptr);
 
   /// \see learnt::get_expressions()
   solutiont get_solution() const override;
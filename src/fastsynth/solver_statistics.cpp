@@ -0,0 +1,80 @@
+#include "solver_statistics.h"
+#include "memory_statistics.h"
+
+#include <solvers/prop/prop.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+
+solver_statisticst &solver_statisticst::operator+=(
+  const solver_statisticst &other)
+{
+  queries+=other.queries;
+  variables=std::max(variables, other.variables);
+  clauses=std::max(clauses, other.clauses);
+  conflicts+=other.conflicts;
+  decisions+=other.decisions;
+  propagations+=other.propagations;
+  restarts+=other.restarts;
+  memory_kb+=other.memory_kb;
+  solver_time+=other.solver_time;
+  return *this;
+}
+
+std::ostream &operator<<(std::ostream &out, const solver_statisticst &s)
+{
+  out << s.queries << " queries, "
+      << s.variables << " variables, "
+      << s.clauses << " clauses, "
+      << s.conflicts << " conflicts, "
+      << s.decisions << " decisions, "
+      << s.propagations << " propagations, "
+      << s.restarts << " restarts, "
+      << s.memory_kb << " KB, "
+      << s.solver_time << 's';
+  return out;
+}
+
+decision_proceduret::resultt solve(
+  decision_proceduret &solver,
+  const propt *prop,
+  solver_statisticst &statistics)
+{
+  const sat_countert *counter=dynamic_cast<const sat_countert *>(prop);
+
+  solver_statisticst before;
+  if(counter)
+    counter->get_counters(before);
+
+  const std::size_t peak_before=peak_rss_kb();
+  const auto start_time=std::chrono::steady_clock::now();
+  const decision_proceduret::resultt result=solver();
+
+  statistics.queries++;
+  statistics.solver_time+=std::chrono::duration<double>(
+    std::chrono::steady_clock::now()-start_time).count();
+
+  const std::size_t peak_after=peak_rss_kb();
+  if(peak_after>peak_before)
+    statistics.memory_kb+=peak_after-peak_before;
+
+  if(prop)
+  {
+    statistics.variables=std::max(statistics.variables, prop->no_variables());
+    statistics.clauses=std::max(statistics.clauses, prop->no_clauses());
+  }
+
+  if(counter)
+  {
+    // the counters are cumulative for incremental solvers
+    solver_statisticst after;
+    counter->get_counters(after);
+    statistics.conflicts+=after.conflicts-before.conflicts;
+    statistics.decisions+=after.decisions-before.decisions;
+    statistics.propagations+=after.propagations-before.propagations;
+    statistics.restarts+=after.restarts-before.restarts;
+  }
+
+  return result;
+}
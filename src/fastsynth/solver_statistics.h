@@ -0,0 +1,77 @@
+#ifndef CPROVER_FASTSYNTH_SOLVER_STATISTICS_H_
+#define CPROVER_FASTSYNTH_SOLVER_STATISTICS_H_
+
+#include <solvers/decision_procedure.h>
+
+#include <cstdint>
+#include <iosfwd>
+
+class propt;
+
+/// Size and effort measurements of one or more decision procedure queries.
+struct solver_statisticst
+{
+  solver_statisticst():
+    queries(0),
+    variables(0),
+    clauses(0),
+    conflicts(0),
+    decisions(0),
+    propagations(0),
+    restarts(0),
+    memory_kb(0),
+    solver_time(0)
+  {
+  }
+
+  /// Number of decision procedure invocations.
+  std::size_t queries;
+
+  /// Largest CNF seen after bit-blasting. Zero for the SMT back end.
+  std::size_t variables, clauses;
+
+  /// SAT search effort. Only available with MiniSat back ends.
+  std::uint64_t conflicts, decisions, propagations, restarts;
+
+  /// Growth of the process' resident set high-water mark during the queries
+  /// in KB. Memory of an external SMT solver process is not included.
+  std::size_t memory_kb;
+
+  /// Wall-clock time spent in the solver in seconds. This includes the
+  /// time of the external SMT solver process.
+  double solver_time;
+
+  void clear()
+  {
+    *this=solver_statisticst();
+  }
+
+  solver_statisticst &operator+=(const solver_statisticst &);
+};
+
+std::ostream &operator<<(std::ostream &, const solver_statisticst &);
+
+/// Implemented by SAT back ends that can report their search counters.
+class sat_countert
+{
+public:
+  virtual ~sat_countert()=default;
+
+  /// Reads the counters accumulated since the solver was created.
+  /// \param dest Statistics in which conflicts, decisions, propagations and
+  ///   restarts are overwritten.
+  virtual void get_counters(solver_statisticst &dest) const=0;
+};
+
+/// Runs the decision procedure and records the query in the given statistics.
+/// \param solver Decision procedure to run.
+/// \param prop Propositional back end of `solver`, or `nullptr` if there is
+///   none (e.g. SMT).
+/// \param statistics Statistics to extend by this query.
+/// \return \see decision_proceduret::resultt
+decision_proceduret::resultt solve(
+  decision_proceduret &solver,
+  const propt *prop,
+  solver_statisticst &statistics);
+
+#endif /* CPROVER_FASTSYNTH_SOLVER_STATISTICS_H_ */
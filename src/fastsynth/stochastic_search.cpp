@@ -0,0 +1,673 @@
+#include <fastsynth/stochastic_search.h>
+
+#include <util/arith_tools.h>
+#include <util/mathematical_expr.h>
+#include <util/simplify_expr.h>
+#include <util/std_types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+stochastic_searcht::stochastic_searcht(
+  const namespacet &ns,
+  const problemt &problem,
+  message_handlert &message_handler)
+  : messaget(message_handler),
+    max_steps(1000),
+    beta(1.0),
+    ns(ns),
+    problem(problem)
+{
+}
+
+namespace
+{
+/// Evaluates expressions over concrete values. Bit-vectors are represented
+/// as unsigned numbers below 2^width, Booleans as 0 and 1. Applications of
+/// the candidate functions are evaluated by binding their parameters to the
+/// values of the arguments, hence the constraints need not be instantiated.
+class concrete_evaluatort
+{
+public:
+  using valuest = std::unordered_map<exprt, mp_integer, irep_hash>;
+
+  concrete_evaluatort(const solutiont::functionst &functions, valuest &values)
+    : values(values), parameters(nullptr)
+  {
+    for(const auto &f : functions)
+      this->functions[f.first.get_identifier()] = &f.second;
+  }
+
+  /// \return false if the value is unknown, e.g., for unsupported operators
+  bool operator()(const exprt &expr, mp_integer &result);
+
+protected:
+  valuest &values;
+  std::unordered_map<irep_idt, const exprt *> functions;
+
+  /// The arguments of the function application being evaluated.
+  const std::vector<mp_integer> *parameters;
+
+  bool
+  evaluate_operands(const exprt::operandst &, std::vector<mp_integer> &);
+  bool evaluate_symbol(const exprt &, mp_integer &result);
+};
+
+/// \return the width of a bit-vector type, 0 for other types
+static std::size_t bv_width(const typet &type)
+{
+  if(type.id() == ID_unsignedbv || type.id() == ID_signedbv)
+    return to_bitvector_type(type).get_width();
+  return 0;
+}
+
+/// Wraps the value into the range of the type.
+static mp_integer wrap(const mp_integer &value, const typet &type)
+{
+  const std::size_t width = bv_width(type);
+  if(width == 0)
+    return value;
+
+  const mp_integer modulus = power(2, width);
+  mp_integer result = value % modulus;
+  if(result < 0)
+    result += modulus;
+  return result;
+}
+
+/// \return the value as a signed number if the type is signed
+static mp_integer interpret(const mp_integer &value, const typet &type)
+{
+  if(type.id() != ID_signedbv)
+    return value;
+
+  const std::size_t width = bv_width(type);
+  if(value >= power(2, width - 1))
+    return value - power(2, width);
+  return value;
+}
+
+bool concrete_evaluatort::evaluate_operands(
+  const exprt::operandst &operands,
+  std::vector<mp_integer> &result)
+{
+  result.resize(operands.size());
+  for(std::size_t i = 0; i < result.size(); ++i)
+  {
+    if(!(*this)(operands[i], result[i]))
+      return false;
+  }
+  return true;
+}
+
+bool concrete_evaluatort::evaluate_symbol(const exprt &expr, mp_integer &result)
+{
+  if(expr.id() == ID_symbol && parameters != nullptr)
+  {
+    static const std::string parameter_prefix = "synth::parameter";
+    const std::string &identifier =
+      id2string(to_symbol_expr(expr).get_identifier());
+
+    if(identifier.compare(0, parameter_prefix.size(), parameter_prefix) == 0)
+    {
+      const std::size_t index =
+        std::stoul(identifier.substr(parameter_prefix.size()));
+      if(index >= parameters->size())
+        return false;
+      result = (*parameters)[index];
+      return true;
+    }
+  }
+
+  const auto v_it = values.find(expr);
+  if(v_it == values.end())
+    return false;
+
+  result = v_it->second;
+  return true;
+}
+
+bool concrete_evaluatort::operator()(const exprt &expr, mp_integer &result)
+{
+  const irep_idt &id = expr.id();
+  const typet &type = expr.type();
+
+  if(id == ID_constant)
+  {
+    if(type.id() == ID_bool)
+    {
+      result = expr.is_true() ? 1 : 0;
+      return true;
+    }
+
+    const auto value = numeric_cast<mp_integer>(to_constant_expr(expr));
+    if(!value.has_value())
+      return false;
+    result = wrap(*value, type);
+    return true;
+  }
+  else if(id == ID_symbol || id == ID_nondet_symbol)
+    return evaluate_symbol(expr, result);
+  else if(id == ID_function_application)
+  {
+    const auto &application = to_function_application_expr(expr);
+    const auto f_it =
+      functions.find(application.function().get_identifier());
+    if(f_it == functions.end())
+      return false;
+
+    std::vector<mp_integer> arguments;
+    if(!evaluate_operands(application.arguments(), arguments))
+      return false;
+
+    const std::vector<mp_integer> *caller = parameters;
+    parameters = &arguments;
+    const bool known = (*this)(*f_it->second, result);
+    parameters = caller;
+    return known;
+  }
+  else if(id == ID_if)
+  {
+    const auto &if_expr = to_if_expr(expr);
+    mp_integer condition;
+    if(!(*this)(if_expr.cond(), condition))
+      return false;
+    return (*this)(
+      condition != 0 ? if_expr.true_case() : if_expr.false_case(), result);
+  }
+  else if(id == ID_and || id == ID_or)
+  {
+    // short-circuit, which also tolerates unknown values
+    const bool is_and = id == ID_and;
+    bool known = true;
+    for(const auto &op : expr.operands())
+    {
+      mp_integer value;
+      if(!(*this)(op, value))
+        known = false;
+      else if((value != 0) != is_and)
+      {
+        result = is_and ? 0 : 1;
+        return true;
+      }
+    }
+    result = is_and ? 1 : 0;
+    return known;
+  }
+  else if(id == ID_implies)
+  {
+    mp_integer premise;
+    if(!(*this)(expr.op0(), premise))
+      return false;
+    if(premise == 0)
+    {
+      result = 1;
+      return true;
+    }
+    return (*this)(expr.op1(), result);
+  }
+
+  std::vector<mp_integer> ops;
+  if(!evaluate_operands(expr.operands(), ops))
+    return false;
+
+  if(id == ID_not)
+    result = ops[0] == 0 ? 1 : 0;
+  else if(id == ID_equal || id == ID_notequal)
+    result = (ops[0] == ops[1]) == (id == ID_equal) ? 1 : 0;
+  else if(id == ID_lt || id == ID_le || id == ID_gt || id == ID_ge)
+  {
+    const typet &op_type = expr.op0().type();
+    const mp_integer lhs = interpret(ops[0], op_type);
+    const mp_integer rhs = interpret(ops[1], op_type);
+    bool holds;
+    if(id == ID_lt)
+      holds = lhs < rhs;
+    else if(id == ID_le)
+      holds = lhs <= rhs;
+    else if(id == ID_gt)
+      holds = lhs > rhs;
+    else
+      holds = lhs >= rhs;
+    result = holds ? 1 : 0;
+  }
+  else if(id == ID_plus)
+  {
+    result = 0;
+    for(const auto &op : ops)
+      result += op;
+    result = wrap(result, type);
+  }
+  else if(id == ID_mult)
+  {
+    result = 1;
+    for(const auto &op : ops)
+      result *= op;
+    result = wrap(result, type);
+  }
+  else if(id == ID_minus)
+    result = wrap(ops[0] - ops[1], type);
+  else if(id == ID_unary_minus)
+    result = wrap(-ops[0], type);
+  else if(id == ID_div || id == ID_mod)
+  {
+    const mp_integer lhs = interpret(ops[0], type);
+    const mp_integer rhs = interpret(ops[1], type);
+    if(rhs == 0)
+      return false;
+    result = wrap(id == ID_div ? lhs / rhs : lhs % rhs, type);
+  }
+  else if(id == ID_bitand || id == ID_bitor || id == ID_bitxor)
+  {
+    if(bv_width(type) == 0)
+      return false;
+    result = ops[0];
+    for(std::size_t i = 1; i < ops.size(); ++i)
+    {
+      if(id == ID_bitand)
+        result = bitwise_and(result, ops[i]);
+      else if(id == ID_bitor)
+        result = bitwise_or(result, ops[i]);
+      else
+        result = bitwise_xor(result, ops[i]);
+    }
+  }
+  else if(id == ID_bitnot)
+  {
+    const std::size_t width = bv_width(type);
+    if(width == 0)
+      return false;
+    result = power(2, width) - 1 - ops[0];
+  }
+  else if(id == ID_shl || id == ID_lshr || id == ID_ashr)
+  {
+    const std::size_t width = bv_width(type);
+    if(width == 0)
+      return false;
+
+    const mp_integer &distance = ops[1];
+    if(distance >= mp_integer(width))
+    {
+      // everything is shifted out
+      result =
+        id == ID_ashr && interpret(ops[0], signedbv_typet(width)) < 0
+          ? power(2, width) - 1
+          : mp_integer(0);
+    }
+    else if(id == ID_shl)
+      result = wrap(ops[0] * power(2, distance), type);
+    else if(id == ID_lshr)
+      result = ops[0] / power(2, distance);
+    else
+    {
+      // floor division of the signed value
+      const mp_integer value = interpret(ops[0], signedbv_typet(width));
+      const mp_integer divisor = power(2, distance);
+      mp_integer quotient = value / divisor;
+      if(value < 0 && quotient * divisor != value)
+        quotient -= 1;
+      result = wrap(quotient, type);
+    }
+  }
+  else if(id == ID_typecast)
+  {
+    const typet &op_type = expr.op0().type();
+    if(type.id() == ID_bool)
+      result = ops[0] != 0 ? 1 : 0;
+    else if(
+      bv_width(type) == 0 && type.id() != ID_integer &&
+      type.id() != ID_natural)
+    {
+      return false;
+    }
+    else
+      result = wrap(interpret(ops[0], op_type), type);
+  }
+  else
+    return false;
+
+  return true;
+}
+}
+
+void stochastic_searcht::add_ce(const counterexamplet &ce)
+{
+  valuest values;
+
+  for(const auto &assignment : ce.assignment)
+  {
+    const exprt &value = assignment.second;
+
+    if(value.is_true() || value.is_false())
+      values[assignment.first] = value.is_true() ? 1 : 0;
+    else if(value.id() == ID_constant)
+    {
+      const auto number = numeric_cast<mp_integer>(to_constant_expr(value));
+      if(number.has_value())
+        values[assignment.first] = wrap(*number, value.type());
+    }
+  }
+
+  counterexamples.push_back(std::move(values));
+}
+
+std::size_t stochastic_searcht::pick(const std::size_t n)
+{
+  return std::uniform_int_distribution<std::size_t>(0, n - 1)(random);
+}
+
+std::size_t stochastic_searcht::cost(const solutiont::functionst &functions)
+{
+  std::size_t result = 0;
+
+  for(const valuest &ce : counterexamples)
+  {
+    valuest values(ce);
+    concrete_evaluatort evaluate(functions, values);
+    bool applies = true;
+
+    for(const exprt &sc : problem.side_conditions)
+    {
+      // side conditions from symex define the intermediate variables
+      if(
+        sc.id() == ID_equal && to_equal_expr(sc).lhs().id() == ID_symbol &&
+        values.find(to_equal_expr(sc).lhs()) == values.end())
+      {
+        mp_integer value;
+        if(evaluate(to_equal_expr(sc).rhs(), value))
+          values[to_equal_expr(sc).lhs()] = value;
+        continue;
+      }
+
+      mp_integer holds;
+      if(evaluate(sc, holds) && holds == 0)
+      {
+        applies = false;
+        break;
+      }
+    }
+
+    if(!applies)
+      continue;
+
+    // anything that does not evaluate to true counts as failure, the
+    // verifier has the final word
+    for(const exprt &c : problem.constraints)
+    {
+      mp_integer holds;
+      if(!evaluate(c, holds) || holds == 0)
+      {
+        result++;
+        break;
+      }
+    }
+  }
+
+  return result;
+}
+
+/// Collects pointers to all subexpressions, in pre-order.
+static void collect_nodes(exprt &expr, std::vector<exprt *> &nodes)
+{
+  nodes.push_back(&expr);
+  for(auto &op : expr.operands())
+    collect_nodes(op, nodes);
+}
+
+/// Collects the proper subexpressions of the given type.
+static void collect_subexpressions(
+  const exprt &expr,
+  const typet &type,
+  std::vector<exprt> &result)
+{
+  for(const auto &op : expr.operands())
+  {
+    if(op.type() == type)
+      result.push_back(op);
+    collect_subexpressions(op, type, result);
+  }
+}
+
+bool stochastic_searcht::swap_operator(std::vector<exprt *> &nodes)
+{
+  static const std::vector<std::vector<irep_idt>> groups = {
+    {ID_plus, ID_minus, ID_mult},
+    {ID_bitand, ID_bitor, ID_bitxor},
+    {ID_shl, ID_ashr, ID_lshr},
+    {ID_lt, ID_le, ID_gt, ID_ge, ID_equal, ID_notequal},
+    {ID_and, ID_or}};
+
+  std::vector<std::pair<exprt *, const std::vector<irep_idt> *>> candidates;
+  for(exprt *node : nodes)
+  {
+    if(node->operands().size() != 2)
+      continue;
+
+    for(const auto &group : groups)
+    {
+      if(std::find(group.begin(), group.end(), node->id()) != group.end())
+        candidates.emplace_back(node, &group);
+    }
+  }
+
+  if(candidates.empty())
+    return false;
+
+  const auto &candidate = candidates[pick(candidates.size())];
+  const std::vector<irep_idt> &group = *candidate.second;
+  const irep_idt &id = group[pick(group.size())];
+  if(id == candidate.first->id())
+    return false;
+
+  candidate.first->id(id);
+  return true;
+}
+
+bool stochastic_searcht::rewire_operand(
+  std::vector<exprt *> &nodes,
+  const mathematical_function_typet &signature)
+{
+  exprt &node = *nodes[pick(nodes.size())];
+  const typet &type = node.type();
+
+  std::vector<exprt> candidates;
+
+  const auto &parameters = signature.domain();
+  for(std::size_t i = 0; i < parameters.size(); ++i)
+  {
+    if(parameters[i] == type)
+    {
+      candidates.push_back(
+        symbol_exprt("synth::parameter" + std::to_string(i), type));
+    }
+  }
+
+  for(const constant_exprt &literal : problem.literals)
+  {
+    if(literal.type() == type)
+      candidates.push_back(literal);
+  }
+
+  collect_subexpressions(node, type, candidates);
+
+  if(candidates.empty())
+    return false;
+
+  const exprt &replacement = candidates[pick(candidates.size())];
+  if(replacement == node)
+    return false;
+
+  // the replacement may be part of node
+  exprt tmp = replacement;
+  node.swap(tmp);
+  return true;
+}
+
+bool stochastic_searcht::perturb_constant(std::vector<exprt *> &nodes)
+{
+  std::vector<exprt *> constants;
+  for(exprt *node : nodes)
+  {
+    if(node->id() == ID_constant)
+      constants.push_back(node);
+  }
+
+  if(constants.empty())
+    return false;
+
+  exprt &constant = *constants[pick(constants.size())];
+  const typet &type = constant.type();
+
+  if(type.id() == ID_bool)
+  {
+    constant.make_bool(!constant.is_true());
+    return true;
+  }
+
+  std::vector<exprt> candidates;
+  for(const constant_exprt &literal : problem.literals)
+  {
+    if(literal.type() == type)
+      candidates.push_back(literal);
+  }
+
+  const auto value = numeric_cast<mp_integer>(to_constant_expr(constant));
+  if(value.has_value())
+  {
+    candidates.push_back(from_integer(*value + 1, type));
+    candidates.push_back(from_integer(*value - 1, type));
+    candidates.push_back(from_integer(0, type));
+  }
+
+  if(candidates.empty())
+    return false;
+
+  const exprt &replacement = candidates[pick(candidates.size())];
+  if(replacement == constant)
+    return false;
+
+  constant = replacement;
+  return true;
+}
+
+bool stochastic_searcht::mutate(const symbol_exprt &function, exprt &body)
+{
+  std::vector<exprt *> nodes;
+  collect_nodes(body, nodes);
+
+  switch(pick(3))
+  {
+  case 0:
+    return swap_operator(nodes);
+  case 1:
+    return rewire_operand(
+      nodes, to_mathematical_function_type(function.type()));
+  default:
+    return perturb_constant(nodes);
+  }
+}
+
+bool stochastic_searcht::operator()(const solutiont &start)
+{
+  if(counterexamples.empty() || start.functions.empty())
+    return false;
+
+  solutiont::functionst current = start.functions;
+  std::size_t current_cost = cost(current);
+
+  // the evaluator cannot tell why the start is wrong
+  if(current_cost == 0)
+    return false;
+
+  std::uniform_real_distribution<double> uniform(0, 1);
+
+  for(std::size_t step = 0; step < max_steps; ++step)
+  {
+    solutiont::functionst next = current;
+    auto function = next.begin();
+    std::advance(function, pick(next.size()));
+
+    if(!mutate(function->first, function->second))
+      continue;
+
+    const std::size_t next_cost = cost(next);
+
+    if(next_cost == 0)
+    {
+      for(auto &f : next)
+        f.second = simplify_expr(f.second, ns);
+
+      if(next == start.functions)
+        continue;
+
+      debug() << "Stochastic search succeeded after " << step + 1
+              << " steps" << eom;
+      solution.functions.swap(next);
+      solution.s_functions.clear();
+      return true;
+    }
+
+    // Metropolis: always accept improvements, worse ones sometimes
+    if(
+      next_cost <= current_cost ||
+      uniform(random) <
+        std::exp(-beta * static_cast<double>(next_cost - current_cost)))
+    {
+      current.swap(next);
+      current_cost = next_cost;
+    }
+  }
+
+  debug() << "Stochastic search failed, best candidate fails "
+          << current_cost << " counterexamples" << eom;
+  return false;
+}
+
+stochastic_learnt::stochastic_learnt(
+  const namespacet &ns,
+  const problemt &problem,
+  std::unique_ptr<learnt> learner,
+  message_handlert &message_handler)
+  : learnt(message_handler),
+    search(ns, problem, message_handler),
+    learner(std::move(learner))
+{
+}
+
+void stochastic_learnt::set_program_size(const size_t program_size)
+{
+  learner->set_program_size(program_size);
+}
+
+decision_proceduret::resultt stochastic_learnt::operator()()
+{
+  if(search(solution))
+  {
+    status() << "Stochastic search found candidate" << eom;
+    solution = search.solution;
+    solver_statistics.clear();
+    expression_statistics.clear();
+    return decision_proceduret::resultt::D_SATISFIABLE;
+  }
+
+  const decision_proceduret::resultt result = (*learner)();
+  solver_statistics = learner->solver_statistics;
+  expression_statistics = learner->expression_statistics;
+
+  if(result == decision_proceduret::resultt::D_SATISFIABLE)
+    solution = learner->get_solution();
+
+  return result;
+}
+
+solutiont stochastic_learnt::get_solution() const
+{
+  return solution;
+}
+
+void stochastic_learnt::add_ce(const counterexamplet &ce)
+{
+  search.add_ce(ce);
+  learner->add_ce(ce);
+}
@@ -0,0 +1,125 @@
+#ifndef CPROVER_FASTSYNTH_STOCHASTIC_SEARCH_H_
+#define CPROVER_FASTSYNTH_STOCHASTIC_SEARCH_H_
+
+#include <fastsynth/cegis_types.h>
+#include <fastsynth/learn.h>
+
+#include <util/irep_hash.h>
+#include <util/mathematical_types.h>
+#include <util/message.h>
+#include <util/mp_arith.h>
+#include <util/namespace.h>
+
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+/// Markov chain Monte Carlo search for candidates near a given one, in the
+/// style of STOKE: the candidate's expressions are mutated at random, and a
+/// mutation is kept with a probability that falls with the number of
+/// counterexamples it fails. Candidates are evaluated on the counterexamples
+/// by a concrete interpreter instead of a solver, which allows many of them
+/// to be tried per CEGIS iteration.
+class stochastic_searcht : public messaget
+{
+public:
+  /// Creates a search for the given problem.
+  /// \param ns Namespace used for simplification.
+  /// \param problem Problem whose constraints the candidates must satisfy.
+  /// \param message_handler Handler for log output.
+  stochastic_searcht(
+    const namespacet &ns,
+    const problemt &problem,
+    message_handlert &message_handler);
+
+  /// Adds a counterexample all candidates found must pass.
+  void add_ce(const counterexamplet &);
+
+  /// Searches from the given candidate for one that passes all
+  /// counterexamples.
+  /// \param start Candidate to start from.
+  /// \return true if one was found, which is then in solution
+  bool operator()(const solutiont &start);
+
+  /// The candidate found by the last successful search.
+  solutiont solution;
+
+  /// Number of mutations tried per search.
+  std::size_t max_steps;
+
+  /// Controls how likely a mutation that fails more counterexamples is
+  /// kept: the probability is exp(-beta * additional failures).
+  double beta;
+
+protected:
+  const namespacet &ns;
+  const problemt &problem;
+
+  /// Values of free variables and intermediate symbols.
+  using valuest = std::unordered_map<exprt, mp_integer, irep_hash>;
+
+  /// The counterexamples, with bit-vector values as unsigned numbers and
+  /// Booleans as 0 and 1.
+  std::vector<valuest> counterexamples;
+
+  std::mt19937 random;
+
+  /// \return number of counterexamples the functions fail
+  std::size_t cost(const solutiont::functionst &);
+
+  /// Applies a random mutation to the body of a function.
+  /// \return false if the chosen mutation was not applicable
+  bool mutate(const symbol_exprt &function, exprt &body);
+
+  /// Replaces the operator of a binary expression by a related one.
+  bool swap_operator(std::vector<exprt *> &nodes);
+
+  /// Replaces an expression by a parameter, a literal, or one of its
+  /// subexpressions.
+  bool rewire_operand(
+    std::vector<exprt *> &nodes,
+    const mathematical_function_typet &signature);
+
+  /// Replaces a constant by a literal or a nearby value.
+  bool perturb_constant(std::vector<exprt *> &nodes);
+
+  /// \return a uniformly chosen number in [0, n)
+  std::size_t pick(std::size_t n);
+};
+
+/// Learner that first searches stochastically from its last candidate, and
+/// asks the wrapped learner only if that fails.
+class stochastic_learnt : public learnt
+{
+public:
+  /// \param ns \see stochastic_searcht::stochastic_searcht
+  /// \param problem \see stochastic_searcht::stochastic_searcht
+  /// \param learner Learner to use when the stochastic search fails.
+  /// \param message_handler Handler for log output.
+  stochastic_learnt(
+    const namespacet &ns,
+    const problemt &problem,
+    std::unique_ptr<learnt> learner,
+    message_handlert &message_handler);
+
+  /// \see learnt::set_program_size(size_t)
+  void set_program_size(size_t program_size) override;
+
+  /// \see learnt::operator()()
+  decision_proceduret::resultt operator()() override;
+
+  /// \see learnt::get_solution()
+  solutiont get_solution() const override;
+
+  /// \see learnt::add_ce(const counterexamplet &)
+  void add_ce(const counterexamplet &) override;
+
+protected:
+  stochastic_searcht search;
+  std::unique_ptr<learnt> learner;
+
+  /// The last candidate provided.
+  solutiont solution;
+};
+
+#endif /* CPROVER_FASTSYNTH_STOCHASTIC_SEARCH_H_ */
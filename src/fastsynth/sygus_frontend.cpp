@@ -1,7 +1,10 @@
 #include "sygus_frontend.h"
 #include "sygus_parser.h"
 #include "cegis.h"
+#include "cegis_options.h"
 #include "literals.h"
+#include "mapped_file.h"
+#include "problem_serialization.h"
 
 #include <util/cout_message.h>
 #include <util/namespace.h>
@@ -41,15 +44,15 @@ int sygus_frontend(const cmdlinet &cmdline)
 
   message_handler.set_verbosity(v);
 
-  std::ifstream in(cmdline.args.front());
+  const mapped_filet file(cmdline.args.front());
 
-  if(!in)
+  if(!file.is_open())
   {
     message.error() << "Failed to open input file" << messaget::eom;
     return 10;
   }
 
-  sygus_parsert parser(in);
+  sygus_parsert parser(file.data(), file.data()+file.size());
 
   try
   {
@@ -67,24 +70,7 @@ int sygus_frontend(const cmdlinet &cmdline)
   cegist cegis(ns);
   cegis.set_message_handler(message_handler);
 
-  if(cmdline.isset("max-program-size"))
-    cegis.max_program_size=std::stol(
-      cmdline.get_value("max-program-size"));
-  else
-    cegis.max_program_size=5; // default
-
-  if(cmdline.isset("min-program-size"))
-    cegis.min_program_size=std::stol(cmdline.get_value("min-program-size"));
-  else
-    cegis.min_program_size=1; // default
-
-  cegis.incremental_solving=cmdline.isset("incremental");
-  cegis.use_simp_solver=cmdline.isset("simplifying-solver");
-  cegis.use_fm=cmdline.isset("fm");
-  cegis.use_local_search=cmdline.isset("local-search");
-  cegis.enable_bitwise=!cmdline.isset("no-bitwise");
-  cegis.use_smt=cmdline.isset("smt");
-  cegis.enable_division=cmdline.isset("enable-division");
+  set_cegis_options(cmdline, cegis);
   cegis.logic=parser.logic;
 
   problemt problem;
@@ -93,15 +79,23 @@ int sygus_frontend(const cmdlinet &cmdline)
   for(const auto &v : parser.variable_map)
     problem.free_variables.insert(symbol_exprt(v.first, v.second));
 
-  for(const auto &v: parser.full_let_variable_map)
-    problem.free_variables.insert(symbol_exprt(v.first, v.second));
-
   for(auto &c : problem.constraints)
     parser.expand_function_applications(c);
 
   if(cmdline.isset("literals"))
     add_literals(problem);
 
+  if(cmdline.isset("dump-problem"))
+  {
+    if(!write_problem_file(
+         cmdline.get_value("dump-problem"), ns, problem, parser.logic))
+    {
+      message.error() << "Failed to write problem file" << messaget::eom;
+      return 1;
+    }
+    return 0;
+  }
+
   auto start_time=std::chrono::steady_clock::now();
 
   switch(cegis(problem))
@@ -135,6 +129,14 @@ int sygus_frontend(const cmdlinet &cmdline)
                                std::chrono::steady_clock::now()-start_time).count()
                          << 's'
                          << messaget::eom;
+
+    message.statistics() << "Synthesis solver: "
+                         << cegis.synthesis_statistics
+                         << messaget::eom;
+
+    message.statistics() << "Verification solver: "
+                         << cegis.verification_statistics
+                         << messaget::eom;
     break;
 
   case decision_proceduret::resultt::D_UNSATISFIABLE:
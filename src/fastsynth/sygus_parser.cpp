@@ -3,7 +3,6 @@
 #include <util/bv_arithmetic.h>
 #include <util/std_types.h>
 #include <util/std_expr.h>
-#include <util/replace_symbol.h>
 #include <util/arith_tools.h>
 
 #include <cctype>
@@ -86,81 +85,66 @@ exprt::operandst sygus_parsert::operands()
   return result;
 }
 
-exprt sygus_parsert::let_expression(bool first_in_chain)
+exprt sygus_parsert::let_expression()
 {
-  let_counter++;
+  if(next_token()!=OPEN)
+    throw error("expected bindings after let");
 
-  if(peek()!=OPEN && !first_in_chain)
-  {
-    // no need for chaining, single let exprt.
-    auto ops=operands();
+  // the bindings are parallel, hence all values are parsed before
+  // any of the variables is in scope
+  std::vector<std::pair<irep_idt, exprt>> bindings;
 
-    if(ops.size()!=3)
-      throw error("let expression has three components");
-    else if(ops[0].id()!=ID_symbol)
-      throw error("expected symbol in let expression");
-    else
-      return let_exprt(to_symbol_expr(ops[0]), ops[1], ops[2]);
-  }
-  else
+  while(next_token()==OPEN)
   {
-    if(peek()==OPEN && first_in_chain)
-    {
-      next_token(); // eat the '(' that starts the bindings list
-    }
-
-    next_token(); // eat the '(' that starts the next binding
+    if(next_token()!=SYMBOL)
+      throw error("expected symbol in let expression");
 
-    exprt symbol_expr, value_expr, where_expr;
+    const irep_idt identifier=buffer;
+    const typet declared_sort=sort();
+    bindings.emplace_back(identifier, expression());
 
-    // get the symbol that is bound
-    if(next_token()==SYMBOL)
+    if(bindings.back().second.type()!=declared_sort)
     {
-      std::string tmp_buffer;
-      symbol_expr = symbol_exprt(tmp_buffer, sort());
+      throw error()
+        << "type mismatch in let binding of `" << identifier
+        << "': expected `" << declared_sort.pretty() << "' but got `"
+        << bindings.back().second.type().pretty() << '\'';
     }
-    else
-      throw error("expected symbol in let expression");
 
-    // get value
-    value_expr = expression();
-    next_token(); // eat the ')' that closes this binding
-
-    // now rename op0 -- this really happens at the very
-    // end of the let, but that's hard with recursion
-    irep_idt old_id=to_symbol_expr(symbol_expr).get_identifier();
-    irep_idt new_id=id2string(old_id)+
-                    '#'+std::to_string(id_counter++)+
-                    'L'+std::to_string(let_counter++);
+    if(next_token()!=CLOSE)
+      throw error("expected ')' after let binding");
+  }
 
-    to_symbol_expr(symbol_expr).set_identifier(new_id);
-    let_variable_map[new_id]=value_expr.type();
-    full_let_variable_map[new_id]=value_expr.type();
-    renaming_map[old_id]=new_id;
+  if(token!=CLOSE)
+    throw error("expected ')' after let bindings");
 
-    if(peek()!=CLOSE) // we are still in a chain of bindings
-    {
-      // get op2
-      where_expr = let_expression(false);
-    }
-    else
-    {
-      // we are at the end of the chain
-      next_token(); // eat the ')' that closes the bindings list
+  // bind, remembering what is shadowed
+  std::vector<std::pair<irep_idt, exprt>> shadowed;
 
-      if(peek()!=OPEN)
-        throw error("let expects where here");
+  for(auto &binding : bindings)
+  {
+    const auto l_it=let_bindings.find(binding.first);
+    shadowed.emplace_back(
+      binding.first,
+      l_it==let_bindings.end()?static_cast<exprt>(nil_exprt()):l_it->second);
+    let_bindings[binding.first].swap(binding.second);
+  }
 
-      where_expr = expression();
-      next_token(); // eat the final ')' that closes the let exprt
-    }
+  exprt where=expression();
 
-    // don't rename any longer
-    renaming_map.erase(old_id);
-    let_variable_map.clear();
+  if(next_token()!=CLOSE)
+    throw error("expected ')' at end of let");
 
-    return let_exprt(to_symbol_expr(symbol_expr), value_expr, where_expr);
+  // unbind in reverse order, a variable may be bound twice
+  for(auto s_it=shadowed.rbegin(); s_it!=shadowed.rend(); s_it++)
+  {
+    if(s_it->second.is_nil())
+      let_bindings.erase(s_it->first);
+    else
+      let_bindings[s_it->first].swap(s_it->second);
   }
+
+  return where;
 }
 
 exprt sygus_parsert::function_application(
@@ -305,14 +289,14 @@ exprt sygus_parsert::expression()
     else
     {
       // hash it
-      irep_idt identifier=buffer;
+      const irep_idt identifier=buffer;
 
-      // renamed?
-      const auto r_it=renaming_map.find(identifier);
-      if(r_it!=renaming_map.end())
-        identifier=r_it->second;
+      // let variables shadow all others
+      const auto l_it=let_bindings.find(identifier);
 
-      if(identifier==ID_true)
+      if(l_it!=let_bindings.end())
+        return l_it->second; // shared, not copied
+      else if(identifier==ID_true)
         return true_exprt();
       else if(identifier==ID_false)
         return false_exprt();
@@ -328,12 +312,6 @@ exprt sygus_parsert::expression()
       {
         return symbol_exprt(identifier, variable_map[identifier]);
       }
-      else if(let_variable_map.find(identifier)!=
-          let_variable_map.end())
-      {
-        // search let variables, we clear let variables when done with parsing let
-        return symbol_exprt(identifier, let_variable_map[identifier]);
-      }
       else if(function_map.find(identifier)!=
               function_map.end())
       {
@@ -374,10 +352,7 @@ exprt sygus_parsert::expression()
       const irep_idt id=buffer;
 
       if(id==ID_let)
-      {
-        // bool indicates first in chain
-        return let_expression(true);
-      }
+        return let_expression();
 
       auto op=operands();
 
@@ -622,14 +597,14 @@ exprt sygus_parsert::expression()
         {
           return function_application(id, op);
         }
-        else if(local_variable_map.find(id)!=local_variable_map.end())
+        else if(let_bindings.find(id)!=let_bindings.end())
         {
-          symbol_exprt result(id, local_variable_map[id]);
-          return std::move(result);
+          // let variables shadow all others
+          return let_bindings[id];
         }
-        else if(let_variable_map.find(id)!=let_variable_map.end())
+        else if(local_variable_map.find(id)!=local_variable_map.end())
         {
-          symbol_exprt result(id, let_variable_map[id]);
+          symbol_exprt result(id, local_variable_map[id]);
           return std::move(result);
         }
         else if(variable_map.find(id)!=variable_map.end())
@@ -1036,12 +1011,24 @@ void sygus_parsert::GTerm()
 
 void sygus_parsert::expand_function_applications(exprt &expr)
 {
-  for(exprt &op : expr.operands())
-    expand_function_applications(op);
+  expr=expand(expr);
+}
 
-  if(expr.id()==ID_function_application)
+exprt sygus_parsert::expand(const exprt &expr)
+{
+  // let-bound terms are shared, and are expanded once
+  const auto c_it=expansion_cache.find(expr);
+  if(c_it!=expansion_cache.end())
+    return c_it->second;
+
+  exprt result=expr;
+
+  for(exprt &op : result.operands())
+    op=expand(op);
+
+  if(result.id()==ID_function_application)
   {
-    auto &app=to_function_application_expr(expr);
+    auto &app=to_function_application_expr(result);
 
     // look it up
     irep_idt identifier=app.function().get_identifier();
@@ -1053,32 +1040,76 @@ void sygus_parsert::expand_function_applications(exprt &expr)
 
       if(synth_fun_set.find(identifier)!=synth_fun_set.end())
       {
+        // do not expand
         app.function().set_identifier("synth_fun::"+id2string(identifier));
-        return; // do not expand
       }
+      else
+      {
+        // the same function applied to the same expanded arguments
+        const auto a_it=expansion_cache.find(result);
+        if(a_it!=expansion_cache.end())
+          result=a_it->second;
+        else
+        {
+          assert(f.type.domain().size()==
+                 app.arguments().size());
 
-      assert(f.type.domain().size()==
-             app.arguments().size());
-
-      replace_symbolt replace_symbol;
+          argument_mapt arguments;
+          for(std::size_t i=0; i<f.parameter_ids.size(); i++)
+            arguments[f.parameter_ids[i]]=app.arguments()[i];
 
-      std::map<irep_idt, exprt> parameter_map;
-      for(std::size_t i=0; i<f.type.domain().size(); i++)
-      {
-        const auto &parameter_type = f.type.domain()[i];
-        const auto &parameter_id = f.parameter_ids[i];
+          expansion_cachet instances;
+          exprt instance=
+            instantiate(expanded_body(identifier, f), arguments, instances);
 
-        replace_symbol.insert(
-          symbol_exprt(parameter_id, parameter_type),
-          app.arguments()[i]);
+          expansion_cache.emplace(result, instance);
+          result.swap(instance);
+        }
       }
-
-      exprt body=f.body;
-      replace_symbol(body);
-      expand_function_applications(body);
-      expr=body;
     }
   }
+
+  expansion_cache.emplace(expr, result);
+  return result;
+}
+
+const exprt &sygus_parsert::expanded_body(
+  const irep_idt &identifier,
+  const functiont &f)
+{
+  const auto b_it=expanded_bodies.find(identifier);
+  if(b_it!=expanded_bodies.end())
+    return b_it->second;
+
+  exprt body=expand(f.body);
+  return expanded_bodies.emplace(identifier, std::move(body)).first->second;
+}
+
+exprt sygus_parsert::instantiate(
+  const exprt &expr,
+  const argument_mapt &arguments,
+  expansion_cachet &cache)
+{
+  if(expr.id()==ID_symbol)
+  {
+    const auto a_it=arguments.find(to_symbol_expr(expr).get_identifier());
+    return a_it==arguments.end()?expr:a_it->second;
+  }
+
+  if(expr.operands().empty())
+    return expr;
+
+  const auto c_it=cache.find(expr);
+  if(c_it!=cache.end())
+    return c_it->second;
+
+  exprt result=expr;
+
+  for(exprt &op : result.operands())
+    op=instantiate(op, arguments, cache);
+
+  cache.emplace(expr, result);
+  return result;
 }
 
 typet sygus_parsert::sort()
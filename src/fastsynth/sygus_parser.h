@@ -1,22 +1,29 @@
 #include <set>
+#include <unordered_map>
 
-#include <solvers/smt2/smt2_tokenizer.h>
+#include "sygus_tokenizer.h"
 
 #include <util/mathematical_expr.h>
 #include <util/mathematical_types.h>
 
-class sygus_parsert:public smt2_tokenizert
+#include "trace.h"
+
+class sygus_parsert:public sygus_tokenizert
 {
 public:
   explicit sygus_parsert(std::istream &_in):
-    smt2_tokenizert(_in),
-    id_counter(0),
-    let_counter(0)
+    sygus_tokenizert(_in)
+  {
+  }
+
+  sygus_parsert(const char *begin, const char *end):
+    sygus_tokenizert(begin, end)
   {
   }
 
   void parse()
   {
+    trace_scopet trace_scope("parse", "frontend");
     command_sequence();
   }
 
@@ -66,13 +73,11 @@ public:
 
   variable_mapt variable_map;
   variable_mapt local_variable_map;
-  variable_mapt let_variable_map;
-  variable_mapt full_let_variable_map;
 
-  unsigned id_counter;
-  unsigned let_counter;
-  using renaming_mapt=std::map<irep_idt, irep_idt>;
-  renaming_mapt renaming_map;
+  /// The terms bound by the enclosing lets. Uses of a variable share
+  /// the term, which makes let-heavy input a DAG rather than a tree.
+  using let_bindingst=std::map<irep_idt, exprt>;
+  let_bindingst let_bindings;
 
 protected:
   void command_sequence();
@@ -82,7 +87,7 @@ protected:
   void ignore_command();
 
   exprt expression();
-  exprt let_expression(bool first_in_chain);
+  exprt let_expression();
   typet sort();
   exprt::operandst operands();
   signature_with_parameter_idst function_signature();
@@ -93,6 +98,26 @@ protected:
   exprt cast_bv_to_unsigned(exprt &expr);
   void check_bitvector_operands(exprt &expr);
 
+  /// Expanded terms, by the term before expansion. Applications of a
+  /// defined function are also entered with their arguments expanded,
+  /// which memoises the expansion per function and arguments. Expansion
+  /// happens after parsing, and functions cannot be redefined, hence
+  /// the entries stay valid.
+  using expansion_cachet=std::unordered_map<exprt, exprt, irep_hash>;
+  expansion_cachet expansion_cache;
+
+  /// The bodies of the defined functions, with the applications in them
+  /// expanded, by function.
+  std::map<irep_idt, exprt> expanded_bodies;
+
+  exprt expand(const exprt &);
+  const exprt &expanded_body(const irep_idt &, const functiont &);
+
+  /// Substitutes the arguments for the parameters, visiting each shared
+  /// subterm once.
+  using argument_mapt=std::map<irep_idt, exprt>;
+  exprt instantiate(const exprt &, const argument_mapt &, expansion_cachet &);
+
   void NTDef_seq();
   void GTerm_seq();
   void NTDef();
@@ -0,0 +1,208 @@
+#include "sygus_tokenizer.h"
+
+#include <cctype>
+#include <istream>
+#include <iterator>
+
+sygus_tokenizert::sygus_tokenizert(const char *begin, const char *end):
+  pos(begin),
+  end(end),
+  line_no(1),
+  token(NONE),
+  peeked(false)
+{
+}
+
+sygus_tokenizert::sygus_tokenizert(std::istream &in):
+  contents(
+    std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()),
+  pos(contents.data()),
+  end(contents.data()+contents.size()),
+  line_no(1),
+  token(NONE),
+  peeked(false)
+{
+}
+
+/// Characters of simple symbols, see the SMT-LIB standard.
+static bool is_simple_symbol_character(const char ch)
+{
+  switch(ch)
+  {
+  case '~': case '!': case '@': case '$': case '%': case '^': case '&':
+  case '*': case '_': case '-': case '+': case '=': case '<': case '>':
+  case '.': case '?': case '/':
+    return true;
+
+  default:
+    return isalnum(static_cast<unsigned char>(ch))!=0;
+  }
+}
+
+sygus_tokenizert::tokent sygus_tokenizert::next_token()
+{
+  if(peeked)
+    peeked=false;
+  else
+    token=get_token();
+
+  return token;
+}
+
+sygus_tokenizert::tokent sygus_tokenizert::get_simple_symbol()
+{
+  const char *begin=pos;
+
+  while(pos!=end && is_simple_symbol_character(*pos))
+    pos++;
+
+  buffer.assign(begin, pos);
+  return SYMBOL;
+}
+
+sygus_tokenizert::tokent sygus_tokenizert::get_decimal_numeral()
+{
+  const char *begin=pos;
+
+  // decimals have a fractional part
+  while(pos!=end && (isdigit(static_cast<unsigned char>(*pos)) || *pos=='.'))
+    pos++;
+
+  buffer.assign(begin, pos);
+  return NUMERAL;
+}
+
+sygus_tokenizert::tokent sygus_tokenizert::get_bin_or_hex_numeral()
+{
+  // the buffer keeps the #b or #x
+  const char *begin=pos;
+  pos++;
+
+  if(pos==end || (*pos!='b' && *pos!='x'))
+    throw error("unexpected character after '#'");
+
+  const bool hex=*pos=='x';
+  pos++;
+
+  while(pos!=end &&
+        (hex?isxdigit(static_cast<unsigned char>(*pos))!=0:
+             (*pos=='0' || *pos=='1')))
+  {
+    pos++;
+  }
+
+  buffer.assign(begin, pos);
+  return NUMERAL;
+}
+
+sygus_tokenizert::tokent sygus_tokenizert::get_quoted_symbol()
+{
+  const char *begin=++pos;
+
+  while(pos!=end && *pos!='|')
+  {
+    if(*pos=='\n')
+      line_no++;
+    pos++;
+  }
+
+  if(pos==end)
+    throw error("EOF within quoted symbol");
+
+  buffer.assign(begin, pos);
+  pos++; // the closing '|'
+  return SYMBOL;
+}
+
+sygus_tokenizert::tokent sygus_tokenizert::get_string_literal()
+{
+  buffer.clear();
+  pos++;
+
+  while(true)
+  {
+    const char *begin=pos;
+
+    while(pos!=end && *pos!='"')
+    {
+      if(*pos=='\n')
+        line_no++;
+      pos++;
+    }
+
+    if(pos==end)
+      throw error("EOF within string literal");
+
+    buffer.append(begin, pos);
+    pos++;
+
+    // "" is an escaped quote
+    if(pos==end || *pos!='"')
+      return STRING_LITERAL;
+
+    buffer+='"';
+    pos++;
+  }
+}
+
+sygus_tokenizert::tokent sygus_tokenizert::get_token()
+{
+  while(pos!=end)
+  {
+    const char ch=*pos;
+
+    switch(ch)
+    {
+    case '\n':
+      line_no++;
+      pos++;
+      break;
+
+    case ' ':
+    case '\r':
+    case '\t':
+    case '\f':
+    case '\v':
+      pos++;
+      break;
+
+    case ';':
+      // comment until the end of the line
+      while(pos!=end && *pos!='\n')
+        pos++;
+      break;
+
+    case '(':
+      pos++;
+      return OPEN;
+
+    case ')':
+      pos++;
+      return CLOSE;
+
+    case '|':
+      return get_quoted_symbol();
+
+    case '"':
+      return get_string_literal();
+
+    case ':':
+      pos++;
+      get_simple_symbol();
+      return KEYWORD;
+
+    case '#':
+      return get_bin_or_hex_numeral();
+
+    default:
+      if(isdigit(static_cast<unsigned char>(ch)))
+        return get_decimal_numeral();
+      else if(is_simple_symbol_character(ch))
+        return get_simple_symbol();
+      else
+        throw error() << "unexpected character `" << ch << '\'';
+    }
+  }
+
+  return END_OF_FILE;
+}
@@ -0,0 +1,122 @@
+#ifndef CPROVER_FASTSYNTH_SYGUS_TOKENIZER_H_
+#define CPROVER_FASTSYNTH_SYGUS_TOKENIZER_H_
+
+#include <iosfwd>
+#include <sstream>
+#include <string>
+
+/// SMT-LIB2 tokenizer working on the input in memory, with the interface
+/// of smt2_tokenizert. Tokens are scanned with pointers into the input,
+/// and their text is copied into a buffer whose storage is reused, so
+/// tokenizing does not allocate once the buffer has grown to the longest
+/// token.
+class sygus_tokenizert
+{
+public:
+  /// Tokenizes the given characters, which must outlive the tokenizer,
+  /// e.g., a mapped_filet.
+  sygus_tokenizert(const char *begin, const char *end);
+
+  /// Tokenizes the rest of the stream, which is read at once.
+  explicit sygus_tokenizert(std::istream &);
+
+  // the positions point into the contents
+  sygus_tokenizert(const sygus_tokenizert &)=delete;
+  sygus_tokenizert &operator=(const sygus_tokenizert &)=delete;
+
+  class smt2_errort
+  {
+  public:
+    smt2_errort(const std::string &_message, unsigned _line_no):
+      line_no(_line_no)
+    {
+      message << _message;
+    }
+
+    explicit smt2_errort(unsigned _line_no):line_no(_line_no)
+    {
+    }
+
+    smt2_errort(const smt2_errort &other):line_no(other.line_no)
+    {
+      message << other.message.str();
+    }
+
+    std::string what() const
+    {
+      return message.str();
+    }
+
+    unsigned get_line_no() const
+    {
+      return line_no;
+    }
+
+    template <typename T>
+    smt2_errort &operator<<(const T &value)
+    {
+      message << value;
+      return *this;
+    }
+
+  protected:
+    std::ostringstream message;
+    unsigned line_no;
+  };
+
+  enum tokent
+  {
+    NONE,
+    END_OF_FILE,
+    STRING_LITERAL,
+    NUMERAL,
+    SYMBOL,
+    KEYWORD,
+    OPEN,
+    CLOSE
+  };
+
+  tokent next_token();
+
+  tokent peek()
+  {
+    if(!peeked)
+    {
+      token=get_token();
+      peeked=true;
+    }
+
+    return token;
+  }
+
+  smt2_errort error(const std::string &message) const
+  {
+    return smt2_errort(message, line_no);
+  }
+
+  smt2_errort error() const
+  {
+    return smt2_errort(line_no);
+  }
+
+protected:
+  /// The input when read from a stream.
+  const std::string contents;
+
+  const char *pos, *end;
+  unsigned line_no;
+
+  /// The text of the last token.
+  std::string buffer;
+  tokent token;
+  bool peeked;
+
+  tokent get_token();
+  tokent get_simple_symbol();
+  tokent get_decimal_numeral();
+  tokent get_bin_or_hex_numeral();
+  tokent get_quoted_symbol();
+  tokent get_string_literal();
+};
+
+#endif /* CPROVER_FASTSYNTH_SYGUS_TOKENIZER_H_ */
@@ -9,6 +9,7 @@
 
 #include <fastsynth/symex_problem_factory.h>
 #include <fastsynth/cegis_types.h>
+#include <fastsynth/trace.h>
 
 #include <goto-programs/abstract_goto_model.h>
 
@@ -37,6 +38,7 @@ static void symex(
   const optionst &options,
   abstract_goto_modelt &model)
 {
+  trace_scopet trace_scope("symex", "frontend");
   const symbol_tablet &symbol_table = model.get_symbol_table();
   path_lifot path_storage;
   guard_managert guard_manager;
@@ -299,6 +301,15 @@ problemt to_problem(
   symex(msg, new_sym_tab, equation, options, model);
 
   const namespacet ns(model.get_symbol_table());
+  return to_problem(msg, ns, equation);
+}
+
+problemt to_problem(
+  message_handlert &msg,
+  const namespacet &ns,
+  symex_target_equationt &equation)
+{
+  trace_scopet trace_scope("to_problem", "frontend");
   problemt result;
   step_filtert step_filter(equation.SSA_steps);
   step_filter.ignore(is_assert_or_assume);
@@ -20,4 +20,14 @@ class problemt to_problem(
   const class optionst &options,
   class abstract_goto_modelt &model);
 
+/// Converts the result of a symbolic execution to a CEGIS problem.
+/// \param msg Message sink for all SSA conversion tasks.
+/// \param ns Namespace of the symex'ed GOTO model.
+/// \param equation Equation produced by symbolic execution.
+/// \return CEGIS problem modelling the symex'ed GOTO program.
+class problemt to_problem(
+  class message_handlert &msg,
+  const class namespacet &ns,
+  class symex_target_equationt &equation);
+
 #endif /* CPROVER_FASTSYNTH_SYMEX_PROBLEM_FACTORY_H_ */
@@ -542,6 +542,23 @@ exprt e_datat::get_function(
 }
 
 exprt synth_encodingt::operator()(const exprt &expr)
+{
+  if(suffix!=cache_suffix)
+  {
+    cache.clear();
+    cache_suffix=suffix;
+  }
+
+  const auto c_it=cache.find(expr);
+  if(c_it!=cache.end())
+    return c_it->second;
+
+  exprt result=encode(expr);
+  cache.emplace(expr, result);
+  return result;
+}
+
+exprt synth_encodingt::encode(const exprt &expr)
 {
   if(expr.id()==ID_function_application)
   {
@@ -8,6 +8,7 @@
 #include "cegis_types.h"
 
 #include <set>
+#include <unordered_map>
 
 struct e_datat
 {
@@ -129,7 +130,10 @@ public:
 
   virtual ~synth_encodingt() = default;
 
-  virtual exprt operator()(const exprt &);
+  /// Encodes the expression for the current suffix. Shared subexpressions,
+  /// e.g., let-bound terms, are encoded once per suffix, hence the
+  /// constraints may only be cleared when the suffix changes.
+  exprt operator()(const exprt &);
 
   virtual solutiont get_solution(const decision_proceduret &) const;
 
@@ -146,6 +150,14 @@ public:
 
 protected:
   std::map<symbol_exprt, e_datat> e_data_map;
+
+  /// Encodes an expression not found in the cache, calling operator() on
+  /// subexpressions.
+  virtual exprt encode(const exprt &);
+
+  /// The encodings of the expressions seen with cache_suffix.
+  std::unordered_map<exprt, exprt, irep_hash> cache;
+  std::string cache_suffix;
 };
 
 #endif /* CPROVER_FASTSYNTH_SYNTH_ENCODING_H_ */
@@ -0,0 +1,112 @@
+#include "trace.h"
+
+#include <ostream>
+
+tracert::tracert():
+  enabled(false),
+  origin(clockt::now())
+{
+}
+
+void tracert::enable()
+{
+  enabled=true;
+}
+
+void tracert::add_span(
+  const char *name,
+  const char *category,
+  const std::string &detail,
+  clockt::time_point start,
+  clockt::time_point end)
+{
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+
+  eventt event;
+  event.name=name;
+  event.category=category;
+  event.detail=detail;
+  event.start=duration_cast<microseconds>(start-origin).count();
+  event.duration=duration_cast<microseconds>(end-start).count();
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // Chrome wants small thread numbers; hand them out in order of appearance
+  const auto t_it=thread_numbers.emplace(
+    std::this_thread::get_id(), thread_numbers.size()+1);
+  event.thread=t_it.first->second;
+
+  events.push_back(std::move(event));
+}
+
+/// Escapes a string for use in a JSON string literal.
+static void output_json_string(std::ostream &out, const std::string &s)
+{
+  out << '"';
+
+  for(const char ch : s)
+  {
+    switch(ch)
+    {
+    case '"': out << "\\\""; break;
+    case '\\': out << "\\\\"; break;
+    case '\n': out << "\\n"; break;
+    case '\r': out << "\\r"; break;
+    case '\t': out << "\\t"; break;
+    default:
+      if(static_cast<unsigned char>(ch)<0x20)
+      {
+        const char *hex="0123456789abcdef";
+        out << "\\u00" << hex[(ch>>4)&0xf] << hex[ch&0xf];
+      }
+      else
+        out << ch;
+    }
+  }
+
+  out << '"';
+}
+
+void tracert::output(std::ostream &out) const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  out << "{\"traceEvents\":[\n";
+
+  bool first=true;
+  for(const auto &e : events)
+  {
+    if(first)
+      first=false;
+    else
+      out << ",\n";
+
+    out << "{\"name\":";
+    output_json_string(out, e.name);
+    out << ",\"cat\":";
+    output_json_string(out, e.category);
+    out << ",\"ph\":\"X\""
+        << ",\"ts\":" << e.start
+        << ",\"dur\":" << e.duration
+        << ",\"pid\":1"
+        << ",\"tid\":" << e.thread;
+
+    if(!e.detail.empty())
+    {
+      out << ",\"args\":{\"detail\":";
+      output_json_string(out, e.detail);
+      out << '}';
+    }
+
+    out << '}';
+  }
+
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+tracert &global_tracer()
+{
+  static tracert tracer;
+  return tracer;
+}
@@ -0,0 +1,99 @@
+#ifndef CPROVER_FASTSYNTH_TRACE_H_
+#define CPROVER_FASTSYNTH_TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Records timed spans of the synthesis phases in Chrome trace event format,
+/// which can be loaded into chrome://tracing or Perfetto.
+class tracert
+{
+public:
+  using clockt=std::chrono::steady_clock;
+
+  tracert();
+
+  /// Starts recording. Spans are dropped while the tracer is disabled.
+  void enable();
+
+  bool is_enabled() const
+  {
+    return enabled;
+  }
+
+  /// Records a complete event for the calling thread.
+  /// \param name Span name, e.g. the phase.
+  /// \param category Chrome trace category.
+  /// \param detail Optional free text shown in the event arguments.
+  /// \param start Time the span started.
+  /// \param end Time the span ended.
+  void add_span(
+    const char *name,
+    const char *category,
+    const std::string &detail,
+    clockt::time_point start,
+    clockt::time_point end);
+
+  /// Writes all recorded events as a JSON trace object.
+  void output(std::ostream &) const;
+
+protected:
+  struct eventt
+  {
+    const char *name;
+    const char *category;
+    std::string detail;
+    long long start, duration; // microseconds
+    std::size_t thread;
+  };
+
+  std::atomic<bool> enabled;
+  const clockt::time_point origin;
+
+  mutable std::mutex mutex;
+  std::vector<eventt> events;
+  std::map<std::thread::id, std::size_t> thread_numbers;
+};
+
+/// The tracer shared by all components of fastsynth.
+tracert &global_tracer();
+
+/// Records a span covering the lifetime of this object.
+class trace_scopet
+{
+public:
+  /// \param name Span name, must outlive the tracer.
+  /// \param category Chrome trace category, must outlive the tracer.
+  trace_scopet(const char *name, const char *category):
+    name(name),
+    category(category),
+    start(tracert::clockt::now())
+  {
+  }
+
+  ~trace_scopet()
+  {
+    tracert &tracer=global_tracer();
+    if(tracer.is_enabled())
+      tracer.add_span(name, category, detail, start, tracert::clockt::now());
+  }
+
+  trace_scopet(const trace_scopet &)=delete;
+  trace_scopet &operator=(const trace_scopet &)=delete;
+
+  /// Free text attached to the event, e.g. the variable being eliminated.
+  std::string detail;
+
+protected:
+  const char *name;
+  const char *category;
+  const tracert::clockt::time_point start;
+};
+
+#endif /* CPROVER_FASTSYNTH_TRACE_H_ */
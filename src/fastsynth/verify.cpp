@@ -1,5 +1,6 @@
 #include "verify.h"
 #include "solver.h"
+#include "trace.h"
 
 #include <langapi/language_util.h>
 
@@ -22,7 +23,7 @@ void verifyt::output(
 }
 
 decision_proceduret::resultt verifyt::operator()(
-  const solutiont &solution)
+  solutiont &solution)
 {
   status() << green;
   output(solution.functions, status());
@@ -32,6 +33,8 @@ decision_proceduret::resultt verifyt::operator()(
   // are consistent with the function signature
   verify_encodingt::check_function_bodies(solution.functions);
 
+  solver_statistics.clear();
+
   solvert solver_container(use_smt, logic, ns, get_message_handler());
   auto &solver=solver_container.get();
 
@@ -42,7 +45,11 @@ decision_proceduret::resultt verifyt::operator()(
   verify_encoding.free_variables=problem.free_variables;
 
   add_problem(verify_encoding, solver);
-  result=solver();
+
+  {
+    trace_scopet trace_scope("SAT solving", "verification");
+    result=solve(solver, solver_container.get_prop(), solver_statistics);
+  }
 
   if(result==decision_proceduret::resultt::D_SATISFIABLE)
     counterexample=
@@ -57,15 +64,30 @@ void verifyt::add_problem(
   verify_encodingt &verify_encoding,
   decision_proceduret &solver)
 {
-  for(const auto &e : problem.side_conditions)
+  exprt::operandst side_conditions;
+  exprt constraint;
+
   {
-    const exprt encoded=verify_encoding(e);
-    debug() << "sc: " << from_expr(ns, "", encoded) << eom;
-    solver.set_to_true(encoded);
+    trace_scopet trace_scope("encoding", "verification");
+
+    for(const auto &e : problem.side_conditions)
+    {
+      side_conditions.push_back(verify_encoding(e));
+      // printing the tree of shared terms takes exponential time
+      if(message_handler && get_message_handler().get_verbosity() >= M_DEBUG)
+        debug() << "sc: " << from_expr(ns, "", side_conditions.back()) << eom;
+    }
+
+    constraint=verify_encoding(conjunction(problem.constraints));
+    if(message_handler && get_message_handler().get_verbosity() >= M_DEBUG)
+      debug() << "co: !(" << from_expr(ns, "", constraint) << ')' << eom;
   }
 
-  const exprt encoded=verify_encoding(conjunction(problem.constraints));
-  debug() << "co: !(" << from_expr(ns, "", encoded) << ')' << eom;
-  solver.set_to_false(encoded);
+  trace_scopet trace_scope("bit-blasting", "verification");
+
+  for(const exprt &sc : side_conditions)
+    solver.set_to_true(sc);
+
+  solver.set_to_false(constraint);
 }
 
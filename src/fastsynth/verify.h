@@ -2,6 +2,7 @@
 #define CPROVER_FASTSYNTH_VERIFY_H_
 
 #include "cegis_types.h"
+#include "solver_statistics.h"
 #include "verify_encoding.h"
 
 #include <util/message.h>
@@ -22,9 +23,10 @@ public:
   {
   }
 
-  /// Check a new candidate.
+  /// Check a new candidate, which derived classes may replace by an
+  /// improved one.
   /// \return \see decision_proceduret::resultt
-  virtual decision_proceduret::resultt operator()(const solutiont &);
+  virtual decision_proceduret::resultt operator()(solutiont &);
     
   const counterexamplet &get_counterexample() const
   {
@@ -34,6 +36,9 @@ public:
   bool use_smt;
   std::string logic;
 
+  /// Solver statistics of the last invocation of operator().
+  solver_statisticst solver_statistics;
+
 protected:
   const namespacet &ns;
   const problemt &problem;
@@ -63,6 +63,18 @@ void verify_encodingt::check_function_body(
 
 exprt verify_encodingt::operator()(const exprt &expr) const
 {
+  cachet cache;
+  return encode(expr, cache);
+}
+
+exprt verify_encodingt::encode(const exprt &expr, cachet &cache) const
+{
+  const auto c_it=cache.find(expr);
+  if(c_it!=cache.end())
+    return c_it->second;
+
+  exprt result;
+
   if(expr.id()==ID_function_application)
   {
     const auto &e=to_function_application_expr(expr);
@@ -80,23 +92,22 @@ exprt verify_encodingt::operator()(const exprt &expr) const
 
     auto f_it=f_map.find(e.function().get_identifier());
 
-    exprt result=f_it==f_map.end()?
+    result=f_it==f_map.end()?
       from_integer(0, e.type()):f_it->second;
 
     // need to instantiate parameters with arguments
-    exprt instance=instantiate(result, e);
-
-    return instance;
+    result=instantiate(result, e);
   }
   else
   {
-    exprt tmp=expr;
-
-    for(auto &op : tmp.operands())
-      op=(*this)(op);
+    result=expr;
 
-    return tmp;
+    for(auto &op : result.operands())
+      op=encode(op, cache);
   }
+
+  cache.emplace(expr, result);
+  return result;
 }
 
 exprt verify_encodingt::instantiate(
@@ -2,6 +2,7 @@
 #define CPROVER_FASTSYNTH_VERIFY_ENCODING_H_
 
 #include <set>
+#include <unordered_map>
 
 #include <util/mathematical_expr.h>
 #include <util/mathematical_types.h>
@@ -13,6 +14,8 @@
 class verify_encodingt
 {
 public:
+  /// Replaces the applications of the functions by their bodies. Shared
+  /// subexpressions, e.g., let-bound terms, are replaced once.
   exprt operator()(const exprt &) const;
 
   using functionst = solutiont::functionst;
@@ -31,6 +34,10 @@ public:
   static void check_function_bodies(const functionst &);
 
 protected:
+  using cachet = std::unordered_map<exprt, exprt, irep_hash>;
+
+  exprt encode(const exprt &, cachet &) const;
+
   exprt instantiate(
     const exprt &expr,
     const function_application_exprt &e) const;